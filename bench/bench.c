@@ -0,0 +1,179 @@
+/*
+ * bench.c — Benchmark de kernels de cómputo en simulador (make bench)
+ * -------------------------------------------------------------------
+ * Compila los mismos headers que usa el firmware (filter.h, fmt.h, trace.h y
+ * los bucles de startup_loops.h), más src/wdt_supervisor.c y src/ledc.c, con
+ * los flags del perfil (ISA, -Os/-O2, HOT_SRCS) y los ejecuta en QEMU `virt`. Por cada kernel mide instrucciones retiradas
+ * (minstret) y ciclos (mcycle), descontando el costo de la propia medición.
+ *
+ * Salida (UART 16550 de QEMU), una línea por kernel:
+ *   kernel <nombre> instret <n> cycles <n>
+ * bench/run.sh la convierte en métricas y la compara contra bench/baseline.txt.
+ *
+ * Qué código del firmware cubre cada kernel:
+ *   adc_block_filter  -> on_adc_block() de src/main.c: media de un bloque de
+ *                        ADC_BLOCK_SAMPLES muestras + paso de EMA (sólo corre en
+ *                        el firmware con SENSOR_HCSR04=1). Las muestras son
+ *                        sintéticas (LCG de 12 bits), no lecturas del ADC.
+ *   fmt_u32/fmt_hex32 -> fmt.h, usado por los reportes de boot, WDT, traza y bus.
+ *   trace_event       -> trace.h, tal cual lo llaman trap.c y los handlers.
+ *   startup_zero/copy -> los bucles de startup_loops.h que ejecuta startup.S.
+ *   wds_checkin       -> wds_begin()/wds_end() de src/wdt_supervisor.c (HOT_SRCS:
+ *                        -O2 en PROFILE=hot), el par que rodea cada tarea del bucle.
+ *   ledc_set_duty     -> src/ledc.c (HOT_FN); sus registros caen en RAM (sim.ld).
+ *
+ * NOTA: QEMU no modela el pipeline; con -icount shift=0 los ciclos son
+ * deterministas pero ~= instrucciones. Sirven para detectar regresiones, no
+ * como tiempo real en el chip.
+ */
+
+#include <stdint.h>
+#include "cycles.h"
+#include "fmt.h"
+#include "filter.h"
+#include "trace.h"
+#include "ledc.h"
+#include "wdt_supervisor.h"
+
+#define SIM_UART_BASE   0x10000000UL  // ns16550 de QEMU virt
+#define SIM_UART_LSR    5U            // Line Status Register
+#define SIM_UART_THRE   0x20U         // THR vacío
+#define SIM_TEST_BASE   0x00100000UL  // sifive_test: escribir para terminar QEMU
+#define SIM_TEST_PASS   0x5555U
+
+#define BENCH_SAMPLES   1024U
+#define BENCH_ADC_BLOCK 16U     // = ADC_BLOCK_SAMPLES en src/main.c
+#define BENCH_EMA_SHIFT 2U      // = ADC_EMA_SHIFT en src/main.c
+#define BENCH_WORDS     1024U
+#define BENCH_FMT_VALUES 256U
+#define BENCH_CHECKINS  256U
+
+void bench_zero_words(uint32_t *ptr, uint32_t *end);
+void bench_copy_words(uint32_t *dst, uint32_t *end, const uint32_t *src);
+
+trace_ring_t trace_ring;   // En el chip vive en trace.c (.rtc_noinit); aquí RAM común
+
+static uint16_t samples[BENCH_SAMPLES];
+static uint32_t words_src[BENCH_WORDS];
+static uint32_t words_dst[BENCH_WORDS];
+static char fmt_buf[64];
+static uint32_t fmt_len;
+static volatile uint32_t bench_sink;   // Evita que el compilador descarte resultados
+
+static uint32_t overhead_instret;
+static uint32_t overhead_cycles;
+
+static void sim_putc(char c) {
+    volatile uint8_t *uart = (volatile uint8_t *)SIM_UART_BASE;
+    while ((uart[SIM_UART_LSR] & SIM_UART_THRE) == 0U) {
+    }
+    uart[0] = (uint8_t)c;
+}
+
+static void buf_putc(char c) {
+    fmt_buf[fmt_len++ & (sizeof(fmt_buf) - 1U)] = c;
+}
+
+static inline uint32_t instret_now(void) {
+    uint32_t n;
+    __asm__ volatile ("csrr %0, minstret" : "=r"(n));
+    return n;
+}
+
+static void bench_report(const char *name, uint32_t instret, uint32_t cycles) {
+    fmt_put_str(sim_putc, "kernel ");
+    fmt_put_str(sim_putc, name);
+    fmt_put_str(sim_putc, " instret ");
+    fmt_put_u32(sim_putc, instret - overhead_instret);
+    fmt_put_str(sim_putc, " cycles ");
+    fmt_put_u32(sim_putc, cycles - overhead_cycles);
+    sim_putc('\n');
+}
+
+/* Ejecuta el cuerpo entre dos lecturas de contadores y reporta la diferencia. */
+#define BENCH_RUN(name, ...) do {                           \
+        uint32_t i0_ = instret_now();                       \
+        uint32_t c0_ = cycles_now();                        \
+        __VA_ARGS__;                                        \
+        uint32_t c1_ = cycles_now();                        \
+        uint32_t i1_ = instret_now();                       \
+        bench_report((name), i1_ - i0_, c1_ - c0_);         \
+    } while (0)
+
+static void bench_fill(void) {
+    uint32_t lcg = 12345U;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; ++i) {
+        lcg = lcg * 1664525U + 1013904223U;
+        samples[i] = (uint16_t)(lcg >> 20);   // 12 bits, como el ADC
+    }
+    for (uint32_t i = 0; i < BENCH_WORDS; ++i) {
+        words_src[i] = i * 2654435761U;
+    }
+}
+
+int main(void) {
+    bench_fill();
+
+    // Calibración: costo de medir un cuerpo vacío
+    uint32_t i0 = instret_now();
+    uint32_t c0 = cycles_now();
+    uint32_t c1 = cycles_now();
+    uint32_t i1 = instret_now();
+    overhead_instret = i1 - i0;
+    overhead_cycles = c1 - c0;
+
+    // Mismas llamadas que on_adc_block(), una vez por bloque
+    BENCH_RUN("adc_block_filter", {
+        filter_ema_t f;
+        filter_ema_init(&f, filter_block_avg(samples, BENCH_ADC_BLOCK), BENCH_EMA_SHIFT);
+        uint16_t y = 0;
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_ADC_BLOCK) {
+            y = filter_ema_step(&f, filter_block_avg(&samples[i], BENCH_ADC_BLOCK));
+        }
+        bench_sink = y;
+    });
+
+    BENCH_RUN("fmt_u32", {
+        for (uint32_t i = 0; i < BENCH_FMT_VALUES; ++i) {
+            fmt_put_u32(buf_putc, words_src[i]);
+        }
+        bench_sink = fmt_len;
+    });
+
+    BENCH_RUN("fmt_hex32", {
+        for (uint32_t i = 0; i < BENCH_FMT_VALUES; ++i) {
+            fmt_put_hex32(buf_putc, words_src[i]);
+        }
+        bench_sink = fmt_len;
+    });
+
+    BENCH_RUN("trace_event", {
+        for (uint32_t i = 0; i < BENCH_SAMPLES; ++i) {
+            trace_event(TRACE_EV_APP, i, samples[i]);
+        }
+        bench_sink = trace_ring.head;
+    });
+
+    BENCH_RUN("startup_zero", bench_zero_words(words_dst, words_dst + BENCH_WORDS));
+
+    BENCH_RUN("startup_copy", bench_copy_words(words_dst, words_dst + BENCH_WORDS, words_src));
+
+    // Sin wds_start(): el MWDT no existe en el simulador y begin/end no lo tocan
+    wds_register(0U, "bench", 1000000U);
+    BENCH_RUN("wds_checkin", {
+        for (uint32_t i = 0; i < BENCH_CHECKINS; ++i) {
+            wds_begin(0U);
+            wds_end(0U);
+        }
+    });
+
+    BENCH_RUN("ledc_set_duty", {
+        for (uint32_t i = 0; i < BENCH_SAMPLES; ++i) {
+            ledc_set_duty(samples[i] & LEDC_DUTY_MAX);
+        }
+    });
+
+    *(volatile uint32_t *)SIM_TEST_BASE = SIM_TEST_PASS;   // Fin: QEMU sale con código 0
+    for (;;) {
+    }
+}
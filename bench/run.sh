@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+## bench/run.sh - Ejecuta el benchmark en QEMU y lo compara contra la baseline
+## --------------------------------------------------------------------------
+## Uso: bench/run.sh <bench.elf> <app.elf> <baseline.txt> <resultados.txt>
+##  1. Corre bench.elf en QEMU `virt` (-icount shift=0: conteo determinista).
+##  2. Agrega tamaños de secciones del firmware (riscv32-esp-elf-size -A app.elf).
+##  3. Escribe "<métrica> <valor>" en resultados.txt e imprime la tabla de
+##     diferencias contra baseline.txt (mismo formato; '#' = comentario).
+set -e
+BENCH_ELF=${1:?bench.elf}
+APP_ELF=${2:?app.elf}
+BASELINE=${3:?baseline.txt}
+OUT=${4:?resultados.txt}
+QEMU=${QEMU:-qemu-system-riscv32}
+SIZE=${SIZE:-riscv32-esp-elf-size}
+
+RAW="$OUT.raw"
+timeout 60 $QEMU -M virt -smp 1 -m 16M -nographic -bios none -icount shift=0 \
+    -kernel "$BENCH_ELF" > "$RAW"
+
+{
+  tr -d '\r' < "$RAW" | awk '$1 == "kernel" { print $2 ".instret", $4; print $2 ".cycles", $6 }'
+  $SIZE -A "$APP_ELF" | awk '$1 ~ /^\.(text|rodata|data|bss|rtc_noinit)$/ { print "size" $1, $2 }'
+} > "$OUT"
+
+if ! grep -q '^kernel ' "$RAW"; then
+  echo "[ERROR] El benchmark no produjo resultados (ver $RAW)." >&2
+  exit 1
+fi
+
+if ! grep -qv '^#' "$BASELINE"; then
+  echo "[AVISO] $BASELINE no tiene mediciones: no hay contra qué comparar." >&2
+  echo "        Ejecutar 'make bench-baseline' y commitear el archivo." >&2
+fi
+
+awk '
+  NR == FNR { if ($1 !~ /^#/ && NF == 2) base[$1] = $2; next }
+  FNR == 1  { printf "%-28s %10s %10s %10s %8s\n", "metrica", "baseline", "actual", "delta", "%" }
+  {
+    if ($1 in base) {
+      d = $2 - base[$1]
+      p = (base[$1] != 0) ? sprintf("%+.1f", 100.0 * d / base[$1]) : "-"
+      printf "%-28s %10d %10d %+10d %8s\n", $1, base[$1], $2, d, p
+    } else {
+      printf "%-28s %10s %10d %10s %8s\n", $1, "(nuevo)", $2, "-", "-"
+    }
+  }
+' "$BASELINE" "$OUT"
@@ -7,21 +7,37 @@ set -e
 
 TARGET=app
 BUILD_DIR=build
+OPT=${OPT:--Os}              # Ej: OPT=-O2 ./build.sh (ver perfiles en el Makefile)
+ISA=${ISA:-rv32imc}          # Ej: ISA=rv32im ./build.sh (sin instrucciones comprimidas)
 
 mkdir -p $BUILD_DIR
 
-echo "[1/4] Compilando fuentes (startup + main)"  # Genera objetos .o
-riscv32-esp-elf-gcc -Os -march=rv32imc -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+echo "[1/4] Compilando fuentes (startup + main + ledc + uart + trap + trace + wdt_supervisor + evbus)"  # Genera objetos .o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
     -Iinclude -c src/startup.S -o $BUILD_DIR/startup.o
-riscv32-esp-elf-gcc -Os -march=rv32imc -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
     -Iinclude -c src/main.c -o $BUILD_DIR/main.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/ledc.c -o $BUILD_DIR/ledc.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/uart.c -o $BUILD_DIR/uart.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/trap.c -o $BUILD_DIR/trap.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/trace.c -o $BUILD_DIR/trace.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/wdt_supervisor.c -o $BUILD_DIR/wdt_supervisor.o
+riscv32-esp-elf-gcc $OPT -march=$ISA -mabi=ilp32 -ffreestanding -nostdlib -Wall -Wextra \
+    -Iinclude -c src/evbus.c -o $BUILD_DIR/evbus.o
 
 echo "[2/4] Enlazando objetos -> ELF final"       # Aplica linker.ld
 riscv32-esp-elf-gcc -T linker.ld -nostdlib -nostartfiles \
-    $BUILD_DIR/startup.o $BUILD_DIR/main.o -o $BUILD_DIR/$TARGET.elf -Wl,-Map=$BUILD_DIR/$TARGET.map
+    $BUILD_DIR/startup.o $BUILD_DIR/main.o $BUILD_DIR/ledc.o $BUILD_DIR/uart.o $BUILD_DIR/trap.o $BUILD_DIR/trace.o \
+    $BUILD_DIR/wdt_supervisor.o $BUILD_DIR/evbus.o -o $BUILD_DIR/$TARGET.elf -Wl,-Map=$BUILD_DIR/$TARGET.map -lgcc
 
-echo "[3/4] Generando binario plano e imagen para flasheo"  # objcopy + elf2image
-riscv32-esp-elf-objcopy -O binary $BUILD_DIR/$TARGET.elf $BUILD_DIR/$TARGET.bin
+echo "[3/4] Generando imagen para flasheo"          # elf2image
+# Sin objcopy -O binary: .rodata/.data/.text quedan en ventanas muy separadas
+# (0x3C.., 0x3FC8.., 0x42..) y el binario plano rellenaría ~100 MB de huecos.
 esptool.py --chip esp32c3 elf2image $BUILD_DIR/$TARGET.elf --output $BUILD_DIR/image
 
 echo "[4/4] Resumen de tamaños de secciones"    # text/data/bss
@@ -33,3 +49,4 @@ ls -1 $BUILD_DIR
 echo "Para flashear (solo app, requiere bootloader existente):"
 echo "  esptool.py --chip esp32c3 write_flash 0x10000 $BUILD_DIR/image"  # Imagen generada
 echo "Nota: Debe existir bootloader + partition table en 0x0 (flashear un proyecto ESP-IDF si no)."
+echo "Sin bootloader: 'make BOOT=direct image' genera una imagen que la ROM arranca desde 0x0."
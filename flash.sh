@@ -1,23 +1,25 @@
 #!/usr/bin/env bash
 ## flash.sh - Script simple para flashear la aplicación
 ## -----------------------------------------------
-## Uso: ./flash.sh [PUERTO] [BAUD]
+## Uso: ./flash.sh [PUERTO] [BAUD] [OFFSET] [IMAGEN]
 ## Ej:  ./flash.sh /dev/ttyUSB0 460800
-## Requiere que la imagen ya haya sido generada (make o build.sh)
+##      ./flash.sh /dev/ttyUSB0 460800 0x0 build/direct/image   (direct boot)
+## Requiere que la imagen ya haya sido generada (make image o build.sh)
 set -e
 BUILD_DIR=build
 PORT=${1:-/dev/ttyACM0}      # Puerto serie por defecto
 BAUD=${2:-460800}            # Baudrate por defecto
+OFFSET=${3:-0x10000}         # 0x10000 con bootloader de ESP-IDF, 0x0 en direct boot
 
-IMAGE="$BUILD_DIR/image"     # Nombre de archivo generado por elf2image
+IMAGE=${4:-"$BUILD_DIR/image"}  # Nombre de archivo generado por elf2image / mkimage.sh
 
 if [ ! -f $IMAGE ]; then
   echo "[ERROR] No se encontró $IMAGE. Ejecuta 'make' o './build.sh' primero." >&2
   exit 1
 fi
 
-echo "Flasheando aplicación en 0x10000 al puerto $PORT (baud $BAUD)"
-esptool.py --chip esp32c3 --port $PORT --baud $BAUD write_flash 0x10000 $IMAGE
+echo "Flasheando aplicación en $OFFSET al puerto $PORT (baud $BAUD)"
+esptool.py --chip esp32c3 --port $PORT --baud $BAUD write_flash $OFFSET $IMAGE
 
 echo "Listo. (Recuerda: sin UART inicializada no verás texto en consola)"
 echo "Para monitorear (cuando implementes UART):"
@@ -0,0 +1,71 @@
+/*
+ * cycles.h — Contador de ciclos de CPU (equivalente a mcycle) para ESP32-C3.
+ * ------------------------------------------------------------------------
+ * El núcleo del ESP32-C3 no implementa los CSR estándar mcycle/cycle: expone
+ * un contador propio de performance (PCCR, CSR 0x7E2) que se habilita con
+ * PCER (0x7E0, qué contar) y PCMR (0x7E1, contador activo). Es de 32 bits:
+ * a 160 MHz da la vuelta cada ~26 s, así que las restas sin signo de
+ * intervalos cortos son correctas aunque haya desborde.
+ *
+ * La frecuencia NO es fija: el bootloader de ESP-IDF deja la CPU a 80 MHz y el
+ * direct boot corre del cristal (40 MHz). cpu_freq_mhz() la lee de los
+ * registros de clock para convertir µs a ciclos.
+ *
+ * Con -DCYCLES_STD_CSR (benchmark en simulador, `make bench`) se usa el CSR
+ * estándar mcycle, ya que el PCCR sólo existe en el núcleo del C3.
+ */
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdint.h>
+#ifndef CYCLES_STD_CSR
+#include "soc.h"
+#endif
+
+#define CSR_PCER_MACHINE 0x7E0   // Evento a contar (bit 0 = ciclos)
+#define CSR_PCMR_MACHINE 0x7E1   // Modo: bit 0 = contador habilitado
+#define CSR_PCCR_MACHINE 0x7E2   // Valor del contador
+
+#define CYCLES_SIM_MHZ   1000U   // QEMU -icount shift=0: 1 instrucción = 1 ns
+
+#ifdef CYCLES_STD_CSR
+static inline void cycles_init(void) {
+    // mcycle corre desde el reset en el simulador
+}
+
+static inline uint32_t cycles_now(void) {
+    uint32_t c;
+    __asm__ volatile ("csrr %0, mcycle" : "=r"(c));
+    return c;
+}
+
+static inline uint32_t cpu_freq_mhz(void) {
+    return CYCLES_SIM_MHZ;
+}
+#else
+static inline void cycles_init(void) {
+    __asm__ volatile ("csrw %0, %1" :: "i"(CSR_PCER_MACHINE), "r"(1U));
+    __asm__ volatile ("csrw %0, %1" :: "i"(CSR_PCMR_MACHINE), "r"(1U));
+}
+
+static inline uint32_t cycles_now(void) {
+    uint32_t c;
+    __asm__ volatile ("csrr %0, %1" : "=r"(c) : "i"(CSR_PCCR_MACHINE));
+    return c;
+}
+
+/* MHz de la CPU según SOC_CLK_SEL: PLL (80/160) o XTAL/RC_FAST con divisor. */
+static inline uint32_t cpu_freq_mhz(void) {
+    uint32_t sysclk = REG32(SYSTEM_SYSCLK_CONF_REG);
+    uint32_t sel = (sysclk & SYSTEM_SOC_CLK_SEL_M) >> SYSTEM_SOC_CLK_SEL_S;
+    if (sel == SYSTEM_SOC_CLK_SEL_PLL) {
+        return ((REG32(SYSTEM_CPU_PER_CONF_REG) & SYSTEM_CPUPERIOD_SEL_M) == 0U) ? 80U : 160U;
+    }
+    uint32_t src = (sel == SYSTEM_SOC_CLK_SEL_XTAL) ? XTAL_FREQ_MHZ : RC_FAST_FREQ_MHZ;
+    uint32_t mhz = src / ((sysclk & SYSTEM_PRE_DIV_CNT_M) + 1U);
+    return (mhz != 0U) ? mhz : 1U;
+}
+#endif
+
+#endif /* CYCLES_H */
@@ -0,0 +1,95 @@
+/*
+ * evbus.h — Bus de eventos publish/subscribe con buffers sin copia.
+ * ----------------------------------------------------------------
+ * Los drivers (fuentes) publican eventos de tamaño fijo; si el evento trae
+ * datos (bloque del ADC, línea de UART), éstos quedan en un buffer del pool y
+ * el evento sólo lleva su índice: nadie copia el payload.
+ *
+ * Fuentes y suscriptores se declaran con macros que los ubican en secciones
+ * propias (.evbus_sources / .evbus_subs, ver linker.ld). El enlazador arma las
+ * tablas: agregar un sensor nuevo es agregar un archivo con EVBUS_SOURCE() y
+ * EVBUS_SUBSCRIBE(), sin tocar el bucle principal.
+ *
+ *   EVBUS_SOURCE(mi_sensor_poll);                  // void mi_sensor_poll(void)
+ *   EVBUS_SUBSCRIBE(EV_BUTTON, on_button);         // void on_button(const evbus_event_t *)
+ *
+ *   bucle: evbus_poll_sources(); evbus_dispatch();
+ *
+ * Despacho O(1): evbus_init() agrupa una sola vez los suscriptores por tipo;
+ * luego cada evento indexa directamente su lista. Por tipo se cuentan
+ * eventos, descartes y latencia publicación->despacho (ciclos).
+ *
+ * REGLAS:
+ *  - Un solo contexto (bucle principal): no publicar desde interrupciones.
+ *  - El buffer de un evento se libera al terminar sus handlers: no guardar
+ *    punteros a evbus_payload() después de retornar.
+ */
+
+#ifndef EVBUS_H
+#define EVBUS_H
+
+#include <stdint.h>
+#include "fmt.h"
+
+/* Tipos de evento */
+#define EV_TICK         0U   // Una vez por iteración del bucle (arg = nº de iteración)
+#define EV_BUTTON       1U   // Flanco del botón (arg = nivel nuevo)
+#define EV_ECHO         2U   // Eco del HC-SR04 capturado (arg = ancho en µs)
+#define EV_ADC_BLOCK    3U   // Bloque de muestras uint16_t en el buffer (len = bytes)
+#define EV_UART_LINE    4U   // Línea recibida por UART en el buffer (len = caracteres)
+#define EV_TYPES        5U
+
+#define EVBUS_QUEUE_LEN  16U    // Potencia de 2
+#define EVBUS_POOL_BUFS  8U     // Buffers de payload
+#define EVBUS_BUF_SIZE   64U    // Bytes por buffer
+#define EVBUS_MAX_SUBS   16U    // Suscriptores totales (repetido en el ASSERT de linker.ld)
+#define EVBUS_NO_BUF     0xFFU
+
+#if (EVBUS_QUEUE_LEN & (EVBUS_QUEUE_LEN - 1U)) != 0
+#error "EVBUS_QUEUE_LEN debe ser potencia de 2"
+#endif
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  buf;      // Índice en el pool o EVBUS_NO_BUF
+    uint16_t len;      // Bytes válidos en el buffer
+    uint32_t arg;      // Valor inmediato (nivel, ancho de pulso, ...)
+    uint32_t ts;       // cycles_now() al publicar
+} evbus_event_t;
+
+typedef void (*evbus_handler_t)(const evbus_event_t *ev);
+typedef void (*evbus_source_t)(void);
+
+typedef struct {
+    uint32_t type;
+    evbus_handler_t fn;
+} evbus_sub_t;
+
+#define EVBUS_SUBSCRIBE(ev_type, handler)                                   \
+    static const evbus_sub_t evbus_sub_##handler##_##ev_type                \
+    __attribute__((used, section(".evbus_subs"))) = { (ev_type), (handler) }
+
+#define EVBUS_SOURCE(poll_fn)                                               \
+    static const evbus_source_t evbus_src_##poll_fn                         \
+    __attribute__((used, section(".evbus_sources"))) = (poll_fn)
+
+void evbus_init(void);
+void evbus_poll_sources(void);
+void evbus_dispatch(void);
+
+/* Pool: reservar, llenar en el lugar y publicar. Devuelve EVBUS_NO_BUF si no hay. */
+uint32_t evbus_alloc(void);
+uint8_t *evbus_buf(uint32_t buf);
+void evbus_release(uint32_t buf);   // Sólo si se reservó y finalmente no se publica
+
+/* Publica un evento. Si la cola está llena lo descarta (y libera el buffer): 0. */
+int evbus_post(uint32_t type, uint32_t arg, uint32_t buf, uint32_t len);
+
+/* Payload del evento (NULL si no trae buffer). */
+static inline const uint8_t *evbus_payload(const evbus_event_t *ev) {
+    return (ev->buf == EVBUS_NO_BUF) ? 0 : evbus_buf(ev->buf);
+}
+
+void evbus_report(fmt_putc_t putc);
+
+#endif /* EVBUS_H */
@@ -0,0 +1,39 @@
+/*
+ * filter.h — Filtros enteros para muestras del ADC (header-only, sin float).
+ * -------------------------------------------------------------------------
+ *  - EMA (media móvil exponencial) en punto fijo Q8: y += (x - y) / 2^shift.
+ *    shift=3 equivale a alfa = 1/8. Un solo estado de 32 bits por canal.
+ *  - Promedio de bloque: media de n muestras (p.ej. un bloque de conversiones).
+ */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+
+#define FILTER_Q 8U   // Bits fraccionarios del estado EMA
+
+typedef struct {
+    int32_t y;        // Salida en Q8
+    uint8_t shift;    // log2(1/alfa)
+} filter_ema_t;
+
+static inline void filter_ema_init(filter_ema_t *f, uint16_t x0, uint8_t shift) {
+    f->y = (int32_t)x0 << FILTER_Q;
+    f->shift = shift;
+}
+
+static inline uint16_t filter_ema_step(filter_ema_t *f, uint16_t x) {
+    f->y += (((int32_t)x << FILTER_Q) - f->y) >> f->shift;
+    return (uint16_t)(f->y >> FILTER_Q);
+}
+
+static inline uint16_t filter_block_avg(const uint16_t *s, uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        acc += s[i];
+    }
+    return (uint16_t)(n ? acc / n : 0U);
+}
+
+#endif /* FILTER_H */
@@ -0,0 +1,44 @@
+/*
+ * fmt.h — Formateo mínimo de números sin printf (header-only).
+ * -----------------------------------------------------------
+ * Cada función recibe la rutina de salida de a un carácter (p.ej. uart_putc),
+ * así los módulos pueden imprimir reportes sin depender del driver UART.
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+typedef void (*fmt_putc_t)(char c);
+
+static inline void fmt_put_str(fmt_putc_t putc, const char *s) {
+    while (*s) {
+        putc(*s++);
+    }
+}
+
+/* Decimal sin signo, sin ceros a la izquierda. */
+static inline void fmt_put_u32(fmt_putc_t putc, uint32_t v) {
+    char buf[10];
+    uint32_t n = 0;
+    do {
+        buf[n++] = (char)('0' + (v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+    while (n > 0U) {
+        putc(buf[--n]);
+    }
+}
+
+/* Hexadecimal de 8 dígitos con prefijo 0x (direcciones, registros). */
+static inline void fmt_put_hex32(fmt_putc_t putc, uint32_t v) {
+    static const char digits[] = "0123456789abcdef";
+    putc('0');
+    putc('x');
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        putc(digits[(v >> shift) & 0xFU]);
+    }
+}
+
+#endif /* FMT_H */
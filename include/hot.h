@@ -0,0 +1,22 @@
+/*
+ * hot.h — Marcado de funciones calientes para el perfil `make PROFILE=hot`.
+ * -----------------------------------------------------------------------
+ * HOT_FN compila una función a -O2 aunque el resto del archivo sea -Os, y la
+ * agrupa en .text.hot (mejor localidad en la caché de flash). Sólo actúa con
+ * -DHOT_FN_O2 (perfil hot); en los demás perfiles no cambia nada, para que la
+ * comparación entre perfiles sea limpia.
+ *
+ * No usar en funciones `static inline` de headers: GCC no inlinea funciones
+ * con opciones de optimización distintas a las del llamador.
+ */
+
+#ifndef HOT_H
+#define HOT_H
+
+#ifdef HOT_FN_O2
+#define HOT_FN __attribute__((hot, optimize("O2")))
+#else
+#define HOT_FN
+#endif
+
+#endif /* HOT_H */
@@ -0,0 +1,16 @@
+/*
+ * ledc.h — PWM por hardware (LEDC, canal 0 low-speed -> GPIO3).
+ */
+
+#ifndef LEDC_H
+#define LEDC_H
+
+#include <stdint.h>
+
+#define LEDC_TIMER_RES_BITS    10U
+#define LEDC_DUTY_MAX        ((1U << LEDC_TIMER_RES_BITS) - 1U)
+
+void ledc_init(void);
+void ledc_set_duty(uint32_t duty);   // 0..LEDC_DUTY_MAX (se satura)
+
+#endif /* LEDC_H */
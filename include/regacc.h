@@ -0,0 +1,169 @@
+/*
+ * regacc.h — Capa mínima de acceso a registros (header-only).
+ * ------------------------------------------------------------
+ * OBJETIVO:
+ *  - Describir campos de registro con descriptores tipados (máscara + shift).
+ *  - Mantener copias "sombra" en RAM de registros que en la práctica sólo se
+ *    escriben (IO_MUX, conf de canales LEDC, ...), para no releerlos por el bus
+ *    de periféricos en cada read-modify-write.
+ *  - Agrupar varias actualizaciones de campos y escribirlas con UN solo store.
+ *
+ * COSTO DE REFERENCIA: cada lectura MMIO cruza el bus APB y cuesta bastantes
+ * ciclos más que una lectura de DRAM. Un `REG32(x) |= bit` son 1 lectura + 1
+ * escritura; con una sombra es 0 lecturas + 1 escritura.
+ *
+ * REGLAS DE USO:
+ *  - Sólo usar sombra si el hardware no modifica el registro por su cuenta
+ *    (nunca para registros de estado, contadores o FIFOs).
+ *  - Bits auto-limpiables (p.ej. DUTY_START, PARA_UP) se disparan con
+ *    reg_shadow_pulse(): se escriben pero no quedan guardados en la sombra.
+ *
+ * ESTADÍSTICAS: con -DREGACC_STATS (automático en -DREGACC_HOST) se cuentan
+ * las lecturas/escrituras MMIO reales de los registros con sombra.
+ * `make regacc-report` compila src/uart.c y src/ledc.c para el host (REG32
+ * apunta a un banco simulado) y las compara con los accesos que hacía el
+ * código reemplazado en esos mismos drivers.
+ */
+
+#ifndef REGACC_H
+#define REGACC_H
+
+#include <stdint.h>
+
+#define BIT(n) (1U << (n))                    // Máscara de un bit
+#ifdef REGACC_HOST
+/* En el host REG32 va al banco simulado (ver abajo). Sus accesos no se cuentan:
+ * las estadísticas sólo cubren los registros manejados con esta capa. */
+#define REG32(addr) (*(volatile uint32_t *)regacc_host_slot((uintptr_t)(addr)))
+#else
+#define REG32(addr) (*(volatile uint32_t *)(addr)) // Acceso directo a registro de 32 bits
+#endif
+
+/* Descriptor de campo: valor = (reg & mask) >> shift. */
+typedef struct {
+    uint32_t mask;   // Máscara ya desplazada (igual que los *_M del TRM)
+    uint8_t  shift;  // Posición del bit menos significativo (*_S)
+} reg_field_t;
+
+#define REG_FIELD(mask_, shift_) { (mask_), (shift_) }
+
+/* Sombra en RAM de un registro. `dirty` indica cambios aún no escritos. */
+typedef struct {
+    uintptr_t addr;
+    uint32_t  value;
+    uint32_t  dirty;
+} reg_shadow_t;
+
+#define REG_SHADOW_INIT(reg) { (uintptr_t)(reg), 0U, 0U }
+
+#if defined(REGACC_HOST) && !defined(REGACC_STATS)
+#define REGACC_STATS
+#endif
+
+#ifdef REGACC_STATS
+/* Lecturas/escrituras MMIO reales de los registros manejados con esta capa. */
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+} regacc_stats_t;
+
+/* Definido una vez por quien habilita las estadísticas (tools/regacc_report.c). */
+extern regacc_stats_t regacc_stats;
+
+#define REGACC_COUNT(field, n) (regacc_stats.field += (n))
+#else
+#define REGACC_COUNT(field, n) ((void)0)
+#endif
+
+#ifdef REGACC_HOST
+/* En el host no hay periféricos: un pequeño banco de registros simulado. */
+#define REGACC_HOST_SLOTS 128U
+
+/* Definidos en tools/regacc_report.c. */
+extern uintptr_t regacc_host_addr[REGACC_HOST_SLOTS];
+extern uint32_t  regacc_host_val[REGACC_HOST_SLOTS];
+
+static inline uint32_t *regacc_host_slot(uintptr_t addr) {
+    uint32_t i = (uint32_t)(addr >> 2) % REGACC_HOST_SLOTS;
+    while (regacc_host_addr[i] != 0U && regacc_host_addr[i] != addr) {
+        i = (i + 1U) % REGACC_HOST_SLOTS;
+    }
+    regacc_host_addr[i] = addr;
+    return &regacc_host_val[i];
+}
+
+static inline uint32_t regacc_mmio_read(uintptr_t addr) {
+    REGACC_COUNT(reads, 1U);
+    return *regacc_host_slot(addr);
+}
+
+static inline void regacc_mmio_write(uintptr_t addr, uint32_t value) {
+    REGACC_COUNT(writes, 1U);
+    *regacc_host_slot(addr) = value;
+}
+#else
+static inline uint32_t regacc_mmio_read(uintptr_t addr) {
+    REGACC_COUNT(reads, 1U);
+    return REG32(addr);
+}
+
+static inline void regacc_mmio_write(uintptr_t addr, uint32_t value) {
+    REGACC_COUNT(writes, 1U);
+    REG32(addr) = value;
+}
+#endif
+
+/* RMW directo de un campo (1 lectura + 1 escritura). Para registros sin sombra. */
+static inline void reg_field_write(uintptr_t addr, const reg_field_t *f, uint32_t v) {
+    uint32_t reg = regacc_mmio_read(addr);
+    reg = (reg & ~f->mask) | ((v << f->shift) & f->mask);
+    regacc_mmio_write(addr, reg);
+}
+
+/* Sincroniza la sombra con el hardware (única lectura MMIO de la sombra). */
+static inline void reg_shadow_load(reg_shadow_t *s) {
+    s->value = regacc_mmio_read(s->addr);
+    s->dirty = 0U;
+}
+
+/* Lectura servida desde RAM. */
+static inline uint32_t reg_shadow_get(const reg_shadow_t *s, const reg_field_t *f) {
+    return (s->value & f->mask) >> f->shift;
+}
+
+/* Actualiza un campo sólo en RAM; se escribe en reg_shadow_commit(). */
+static inline void reg_shadow_field(reg_shadow_t *s, const reg_field_t *f, uint32_t v) {
+    uint32_t next = (s->value & ~f->mask) | ((v << f->shift) & f->mask);
+    s->dirty |= s->value ^ next;
+    s->value = next;
+}
+
+/* Pone a 1 `set` y a 0 `clr` sólo en RAM (equivalente a |= / &= ~). */
+static inline void reg_shadow_bits(reg_shadow_t *s, uint32_t set, uint32_t clr) {
+    uint32_t next = (s->value & ~clr) | set;
+    s->dirty |= s->value ^ next;
+    s->value = next;
+}
+
+/* Escribe todos los cambios pendientes con un solo store (nada si no hay). */
+static inline void reg_shadow_commit(reg_shadow_t *s) {
+    if (s->dirty != 0U) {
+        regacc_mmio_write(s->addr, s->value);
+        s->dirty = 0U;
+    }
+}
+
+/* Dispara bits auto-limpiables junto con lo pendiente, sin leer el registro. */
+static inline void reg_shadow_pulse(reg_shadow_t *s, uint32_t bits) {
+    regacc_mmio_write(s->addr, s->value | bits);
+    s->dirty = 0U;
+}
+
+/* Write-back de un lote de sombras (p.ej. todos los pines de un periférico). */
+static inline void reg_shadow_commit_all(reg_shadow_t *const *set, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        reg_shadow_commit(set[i]);
+    }
+}
+
+#endif /* REGACC_H */
@@ -0,0 +1,15 @@
+/*
+ * rtc_noinit.h — Variables que sobreviven a un reset (RTC FAST memory).
+ * -------------------------------------------------------------------
+ * Lo marcado con RTC_NOINIT va a la sección .rtc_noinit (linker.ld), ubicada en
+ * la RTC FAST memory (0x5000_0000). startup.S NO la limpia y la ROM no la toca
+ * en resets de CPU/sistema (watchdog, software), así que conserva su valor.
+ * Tras un power-on su contenido es basura: validar siempre con un número mágico.
+ */
+
+#ifndef RTC_NOINIT_H
+#define RTC_NOINIT_H
+
+#define RTC_NOINIT __attribute__((section(".rtc_noinit")))
+
+#endif /* RTC_NOINIT_H */
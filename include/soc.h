@@ -0,0 +1,40 @@
+/*
+ * soc.h — Direcciones base y bits de registros compartidos entre drivers.
+ * ----------------------------------------------------------------------
+ * GPIO, IO_MUX y clocks/resets de periféricos (TRM ESP32-C3). Cada driver
+ * (main.c, ledc.c, uart.c) define además los registros propios de su bloque.
+ */
+
+#ifndef SOC_H
+#define SOC_H
+
+#include "regacc.h"
+
+#define DR_REG_GPIO_BASE        0x60004000UL  // Base periférico GPIO
+#define DR_REG_IO_MUX_BASE      0x60009000UL  // Base IO_MUX (selección de función/pulls)
+#define DR_REG_SYSTEM_BASE      0x600C0000UL  // Base registro de sistema (clocks/resets)
+
+#define GPIO_ENABLE_W1TS_REG (DR_REG_GPIO_BASE + 0x0024) // Habilitar OE
+#define GPIO_ENABLE_W1TC_REG (DR_REG_GPIO_BASE + 0x0028) // Deshabilitar OE
+
+#define IO_MUX_FUN_IE       BIT(9)   // Input enable digital
+#define IO_MUX_FUN_PU       BIT(8)   // Pull-up digital
+#define IO_MUX_FUN_PD       BIT(7)   // Pull-down digital
+#define IO_MUX_MCU_SEL_MASK (0x7U << 12) // Selector de función
+#define IO_MUX_MCU_SEL_GPIO 1U       // Función GPIO
+
+#define SYSTEM_PERIP_CLK_EN0_REG (DR_REG_SYSTEM_BASE + 0x0010) // Registro de clocks
+#define SYSTEM_PERIP_RST_EN0_REG (DR_REG_SYSTEM_BASE + 0x0018) // Registro de resets
+
+// Clock de CPU: nadie en este proyecto lo configura, se lee el que dejó el arranque
+#define SYSTEM_CPU_PER_CONF_REG  (DR_REG_SYSTEM_BASE + 0x0008) // Divisor de CPU con PLL
+#define SYSTEM_CPUPERIOD_SEL_M   0x3U                          // 0 = 80 MHz, 1 = 160 MHz
+#define SYSTEM_SYSCLK_CONF_REG   (DR_REG_SYSTEM_BASE + 0x0058) // Fuente y divisor de SOC_CLK
+#define SYSTEM_PRE_DIV_CNT_M     0x3FFU                        // Divisor (XTAL/RC_FAST) - 1
+#define SYSTEM_SOC_CLK_SEL_S     10
+#define SYSTEM_SOC_CLK_SEL_M     (0x3U << SYSTEM_SOC_CLK_SEL_S)
+#define SYSTEM_SOC_CLK_SEL_XTAL  0U
+#define SYSTEM_SOC_CLK_SEL_PLL   1U
+#define XTAL_FREQ_MHZ            40U
+#define RC_FAST_FREQ_MHZ         17U                           // ~17.5 MHz, sin calibrar
+#endif /* SOC_H */
@@ -0,0 +1,32 @@
+/*
+ * startup_loops.h — Bucles de inicialización de memoria (macros de ensamblador).
+ * ---------------------------------------------------------------------------
+ * Sólo para archivos .S. Los usa startup.S (limpiar .bss, copiar .data) y el
+ * benchmark (bench/crt0.S) para medir exactamente el mismo código.
+ * Operan sobre registros; todos los punteros deben estar alineados a 4 bytes.
+ */
+
+#ifndef STARTUP_LOOPS_H
+#define STARTUP_LOOPS_H
+
+/* ZERO_WORDS ptr, end: escribe ceros desde ptr hasta end (ptr avanza). */
+.macro ZERO_WORDS ptr, end
+1:  bge  \ptr, \end, 2f
+    sw   zero, 0(\ptr)
+    addi \ptr, \ptr, 4
+    j    1b
+2:
+.endm
+
+/* COPY_WORDS dst, end, src, tmp: copia palabras desde src hasta llenar [dst, end). */
+.macro COPY_WORDS dst, end, src, tmp
+3:  bge  \dst, \end, 4f
+    lw   \tmp, 0(\src)
+    sw   \tmp, 0(\dst)
+    addi \dst, \dst, 4
+    addi \src, \src, 4
+    j    3b
+4:
+.endm
+
+#endif /* STARTUP_LOOPS_H */
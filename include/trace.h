@@ -0,0 +1,69 @@
+/*
+ * trace.h — Traza binaria post-mortem en RTC FAST memory.
+ * -------------------------------------------------------
+ * Anillo de eventos {timestamp, ID, arg0, arg1} en la sección .rtc_noinit:
+ * sobrevive a resets de watchdog/software, así que tras un reset se puede
+ * volcar lo que el sistema hacía justo antes. trace_event() son unas pocas
+ * instrucciones (reservar índice, leer contador, 4 stores) y puede quedar
+ * habilitado en producción.
+ *
+ * Al arrancar, trace_boot() detecta la causa del reset, vuelca por UART la
+ * traza de la sesión anterior y empieza una sesión nueva.
+ *
+ * NOTA: `head++` es leer/sumar/escribir; si el stage 0 del watchdog entrara en
+ * medio, ambos obtendrían el mismo slot y el evento interrumpido pisaría al de
+ * la ISR. Por eso el índice se reserva con MIE apagado (csrrci/csrw, un par de
+ * ciclos); los 4 stores van después, ya en slots distintos.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "cycles.h"
+#include "fmt.h"
+
+#define TRACE_ENTRIES 128U   // Potencia de 2 (índice con máscara). 128 * 16 B = 2 KB
+
+#if (TRACE_ENTRIES & (TRACE_ENTRIES - 1U)) != 0
+#error "TRACE_ENTRIES debe ser potencia de 2"
+#endif
+
+/* IDs de evento del sistema; la aplicación usa desde TRACE_EV_APP. */
+#define TRACE_EV_BOOT       1U   // a0 = causa de reset, a1 = nº de sesión
+#define TRACE_EV_WDT_STAGE0 2U   // a0 = PC interrumpido, a1 = tarea culpable
+#define TRACE_EV_EXCEPTION  3U   // a0 = mcause, a1 = mepc
+#define TRACE_EV_APP        16U
+
+typedef struct {
+    uint32_t ts;     // cycles_now() al registrar
+    uint32_t id;
+    uint32_t a0;
+    uint32_t a1;
+} trace_entry_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t session;                 // Se incrementa en cada arranque
+    uint32_t head;                    // Total de eventos escritos (libre de desborde: máscara)
+    trace_entry_t entry[TRACE_ENTRIES];
+} trace_ring_t;
+
+extern trace_ring_t trace_ring;
+
+static inline void trace_event(uint32_t id, uint32_t a0, uint32_t a1) {
+    uint32_t mstatus;
+    __asm__ volatile ("csrrci %0, mstatus, 8" : "=r"(mstatus) :: "memory");   // MIE = 0
+    uint32_t slot = trace_ring.head++;
+    __asm__ volatile ("csrw mstatus, %0" :: "r"(mstatus) : "memory");          // MIE previo
+    trace_entry_t *e = &trace_ring.entry[slot & (TRACE_ENTRIES - 1U)];
+    e->ts = cycles_now();
+    e->id = id;
+    e->a0 = a0;
+    e->a1 = a1;
+}
+
+uint32_t trace_reset_reason(void);
+void trace_boot(fmt_putc_t putc);
+
+#endif /* TRACE_H */
@@ -0,0 +1,24 @@
+/*
+ * uart.h — UART0 a 115200 (TX=GPIO21, RX=GPIO20), por polling.
+ */
+
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+
+void uart_init(void);
+void uart_putc(char c);              // Bloquea sólo si el FIFO (o el anillo) está lleno
+void uart_puts(const char *s);
+
+/* Salida diferida (reportes largos): uart_putc_queued() sólo copia al anillo
+ * (si está lleno, descarta) y uart_tx_pump() pasa al FIFO lo que entra, sin
+ * esperar. Devuelve los caracteres que quedan pendientes. */
+#define UART_TX_RING_LEN    512U    // Potencia de 2
+void uart_putc_queued(char c);
+uint32_t uart_tx_pump(void);
+
+uint32_t uart_rx_count(void);        // Bytes esperando en el FIFO de RX
+char uart_rx_byte(void);             // Sólo si uart_rx_count() > 0
+
+#endif /* UART_H */
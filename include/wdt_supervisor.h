@@ -0,0 +1,45 @@
+/*
+ * wdt_supervisor.h — Supervisor de plazos por tarea sobre el MWDT de TIMG0.
+ * -----------------------------------------------------------------------
+ * En lugar de deshabilitar el watchdog, se lo deja armado y sólo se lo
+ * alimenta cuando TODAS las tareas registradas hicieron check-in dentro de su
+ * plazo desde la última alimentación. Si alguna se cuelga (p.ej. un busy-wait
+ * sin timeout) o se pasa de su plazo, el MWDT no se alimenta y:
+ *
+ *   stage 0 (interrupción) -> se guarda en RTC memory el PC interrumpido y el
+ *                             ID de la tarea culpable.
+ *   stage 1 (reset sistema) -> el chip reinicia.
+ *
+ * Al arrancar, wds_boot_report() imprime lo capturado y el peor tiempo de
+ * ejecución (WCET, en ciclos) de cada tarea en la sesión anterior.
+ *
+ * USO:
+ *   wds_register(ID, "nombre", plazo_us);   // una vez por tarea
+ *   wds_boot_report(uart_putc);             // tras inicializar la UART
+ *   wds_start(timeout_ms);                  // arma el MWDT
+ *   ...
+ *   wds_begin(ID); trabajo(); wds_end(ID);  // en cada iteración
+ *   wds_poll();                             // en el bucle principal
+ */
+
+#ifndef WDT_SUPERVISOR_H
+#define WDT_SUPERVISOR_H
+
+#include <stdint.h>
+#include "fmt.h"
+
+#define WDS_MAX_TASKS  8U
+#define WDS_NO_TASK    0xFFU
+#define WDS_CPU_INT    1U       // Línea de interrupción de CPU usada por el stage 0
+
+void wds_register(uint32_t id, const char *name, uint32_t deadline_us);
+void wds_start(uint32_t timeout_ms);
+void wds_begin(uint32_t id);
+void wds_end(uint32_t id);
+void wds_poll(void);
+void wds_boot_report(fmt_putc_t putc);
+
+/* Llamado desde trap_dispatch() (src/trap.c) con el PC interrumpido. */
+void wds_stage0_isr(uint32_t mepc);
+
+#endif /* WDT_SUPERVISOR_H */
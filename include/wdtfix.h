@@ -7,9 +7,6 @@
 
 #include <stdint.h>
 
-/* Mantiene un segmento .rodata pequeño para el enlace en DROM. */
-static const char app_banner[] __attribute__((used)) = "ESP32-C3 baremetal demo";
- 
 #define TIMG0_BASE 0x6001F000UL
 #define TIMG1_BASE 0x60020000UL
 #define TIMG_WDTCONFIG0_OFFSET 0x0048
@@ -39,7 +36,7 @@ static const char app_banner[] __attribute__((used)) = "ESP32-C3 baremetal demo"
 #define RTC_CNTL_WDT_UNLOCK_KEY 0x50D83AA1U
 #define RTC_CNTL_SWD_UNLOCK_KEY 0x8F1D312AU
  
-static void disable_timg_wdt(uint32_t timer_base) {
+static inline void disable_timg_wdt(uint32_t timer_base) {
     volatile uint32_t *wdt_protect = (volatile uint32_t *)(timer_base + TIMG_WDTWPROTECT_OFFSET);
     volatile uint32_t *wdt_config0 = (volatile uint32_t *)(timer_base + TIMG_WDTCONFIG0_OFFSET);
     volatile uint32_t *wdt_config1 = (volatile uint32_t *)(timer_base + TIMG_WDTCONFIG1_OFFSET);
@@ -72,7 +69,7 @@ static void disable_timg_wdt(uint32_t timer_base) {
     *wdt_protect = 0;
 }
  
-static void disable_rtc_wdts(void) {
+static inline void disable_rtc_wdts(void) {
     volatile uint32_t *wdt_protect = (volatile uint32_t *)(RTC_CNTL_BASE + RTC_CNTL_WDTWPROTECT_OFFSET);
     volatile uint32_t *wdt_config0 = (volatile uint32_t *)(RTC_CNTL_BASE + RTC_CNTL_WDTCONFIG0_OFFSET);
     volatile uint32_t *wdt_config1 = (volatile uint32_t *)(RTC_CNTL_BASE + RTC_CNTL_WDTCONFIG1_OFFSET);
@@ -0,0 +1,39 @@
+#!/usr/bin/env bash
+## mkimage.sh - Genera la imagen a flashear según la variante de arranque
+## ---------------------------------------------------------------------
+## Uso: ./mkimage.sh <idf|direct> <app.elf> <salida>
+##  idf    -> `esptool.py elf2image` (la carga el bootloader de 2ª etapa, app en 0x10000)
+##  direct -> binario plano con objcopy; la ROM lo ejecuta desde 0x0 (sin bootloader)
+## En modo direct se verifica la cabecera mágica que exige la ROM (ver linker_direct.ld).
+set -e
+BOOT=${1:?variante (idf|direct)}
+ELF=${2:?archivo ELF}
+OUT=${3:?archivo de salida}
+OBJCOPY=${OBJCOPY:-riscv32-esp-elf-objcopy}
+
+case "$BOOT" in
+  idf)
+    esptool.py --chip esp32c3 elf2image "$ELF" --output "$OUT"
+    ;;
+  direct)
+    "$OBJCOPY" -O binary "$ELF" "$OUT"
+    # Primeros 8 bytes: 0xAEDB041D dos veces (little-endian)
+    MAGIC=$(od -An -tx1 -N8 "$OUT" | tr -d ' \n')
+    if [ "$MAGIC" != "1d04dbae1d04dbae" ]; then
+      echo "[ERROR] $OUT no empieza con la cabecera de direct boot ($MAGIC)." >&2
+      echo "        ¿Se enlazó con linker_direct.ld (make BOOT=direct)?" >&2
+      exit 1
+    fi
+    # Rellenar a múltiplo de 4 bytes (escritura de flash por palabras)
+    SIZE=$(wc -c < "$OUT")
+    PAD=$(( (4 - SIZE % 4) % 4 ))
+    if [ "$PAD" -ne 0 ]; then
+      head -c "$PAD" /dev/zero >> "$OUT"
+    fi
+    echo "Imagen direct boot: $OUT ($(wc -c < "$OUT") bytes) -> flashear en 0x0"
+    ;;
+  *)
+    echo "[ERROR] Variante desconocida: $BOOT (usar idf o direct)" >&2
+    exit 1
+    ;;
+esac
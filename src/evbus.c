@@ -0,0 +1,166 @@
+/*
+ * evbus.c — Bus de eventos (ver evbus.h).
+ *
+ * Las tablas de fuentes y suscriptores las arma el enlazador (secciones
+ * .evbus_sources / .evbus_subs en linker.ld y linker_direct.ld). evbus_init()
+ * las ordena una vez por tipo en RAM; el despacho sólo indexa.
+ */
+
+#include <stdint.h>
+#include "cycles.h"
+#include "evbus.h"
+
+extern const evbus_sub_t __evbus_subs_start[];
+extern const evbus_sub_t __evbus_subs_end[];
+extern const evbus_source_t __evbus_sources_start[];
+extern const evbus_source_t __evbus_sources_end[];
+
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;
+    uint32_t dispatched;
+    uint32_t lat_max;       // Ciclos publicación -> despacho
+    uint64_t lat_sum;       // 64 bits: 32 desbordan tras ~27 s de latencia acumulada (160 MHz)
+} evbus_stats_t;
+
+/* Suscriptores agrupados por tipo: los de tipo t están en
+ * evbus_subs[evbus_first[t]] .. evbus_subs[evbus_first[t + 1] - 1]. */
+static evbus_handler_t evbus_subs[EVBUS_MAX_SUBS];
+static uint8_t evbus_first[EV_TYPES + 1U];
+
+static evbus_event_t evbus_queue[EVBUS_QUEUE_LEN];
+static uint32_t evbus_head;         // Próxima posición a escribir
+static uint32_t evbus_tail;         // Próxima posición a despachar
+
+static uint8_t evbus_pool[EVBUS_POOL_BUFS][EVBUS_BUF_SIZE] __attribute__((aligned(4)));
+static uint8_t evbus_free[EVBUS_POOL_BUFS];   // Pila de índices libres
+static uint32_t evbus_nfree;
+
+static evbus_stats_t evbus_stats[EV_TYPES];
+
+void evbus_init(void) {
+    uint32_t count[EV_TYPES] = { 0 };
+    // El ASSERT de linker.ld/linker_direct.ld ya rechaza más de EVBUS_MAX_SUBS
+    uint32_t n = (uint32_t)(__evbus_subs_end - __evbus_subs_start);
+
+    // Counting sort por tipo (una sola vez)
+    for (uint32_t i = 0; i < n; ++i) {
+        if (__evbus_subs_start[i].type < EV_TYPES) {
+            count[__evbus_subs_start[i].type]++;
+        }
+    }
+    evbus_first[0] = 0U;
+    for (uint32_t t = 0; t < EV_TYPES; ++t) {
+        evbus_first[t + 1U] = (uint8_t)(evbus_first[t] + count[t]);
+        count[t] = evbus_first[t];   // Reutilizado como cursor de inserción
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t t = __evbus_subs_start[i].type;
+        if (t < EV_TYPES) {
+            evbus_subs[count[t]++] = __evbus_subs_start[i].fn;
+        }
+    }
+
+    for (uint32_t i = 0; i < EVBUS_POOL_BUFS; ++i) {
+        evbus_free[i] = (uint8_t)i;
+    }
+    evbus_nfree = EVBUS_POOL_BUFS;
+    evbus_head = 0U;
+    evbus_tail = 0U;
+    cycles_init();
+}
+
+uint32_t evbus_alloc(void) {
+    if (evbus_nfree == 0U) {
+        return EVBUS_NO_BUF;
+    }
+    return evbus_free[--evbus_nfree];
+}
+
+uint8_t *evbus_buf(uint32_t buf) {
+    return evbus_pool[buf];
+}
+
+void evbus_release(uint32_t buf) {
+    if (buf < EVBUS_POOL_BUFS) {
+        evbus_free[evbus_nfree++] = (uint8_t)buf;
+    }
+}
+
+int evbus_post(uint32_t type, uint32_t arg, uint32_t buf, uint32_t len) {
+    if (type >= EV_TYPES) {
+        evbus_release(buf);
+        return 0;
+    }
+    if (evbus_head - evbus_tail >= EVBUS_QUEUE_LEN) {
+        evbus_stats[type].dropped++;
+        evbus_release(buf);
+        return 0;
+    }
+    evbus_event_t *ev = &evbus_queue[evbus_head & (EVBUS_QUEUE_LEN - 1U)];
+    ev->type = (uint8_t)type;
+    ev->buf = (uint8_t)buf;
+    ev->len = (uint16_t)len;
+    ev->arg = arg;
+    ev->ts = cycles_now();
+    evbus_head++;
+    evbus_stats[type].posted++;
+    return 1;
+}
+
+void evbus_poll_sources(void) {
+    for (const evbus_source_t *src = __evbus_sources_start; src < __evbus_sources_end; ++src) {
+        (*src)();
+    }
+}
+
+void evbus_dispatch(void) {
+    // Sólo lo que ya estaba en cola: lo que publiquen los handlers va en la próxima vuelta
+    uint32_t end = evbus_head;
+    while (evbus_tail != end) {
+        // Se copia el descriptor (12 B), no el payload: el slot puede reutilizarse
+        evbus_event_t ev = evbus_queue[evbus_tail & (EVBUS_QUEUE_LEN - 1U)];
+        evbus_tail++;
+
+        evbus_stats_t *st = &evbus_stats[ev.type];
+        uint32_t lat = cycles_now() - ev.ts;
+        st->dispatched++;
+        st->lat_sum += lat;
+        if (lat > st->lat_max) {
+            st->lat_max = lat;
+        }
+
+        for (uint32_t i = evbus_first[ev.type]; i < evbus_first[ev.type + 1U]; ++i) {
+            evbus_subs[i](&ev);
+        }
+        evbus_release(ev.buf);
+    }
+}
+
+static const char *const evbus_names[EV_TYPES] = {
+    [EV_TICK]      = "tick",
+    [EV_BUTTON]    = "button",
+    [EV_ECHO]      = "echo",
+    [EV_ADC_BLOCK] = "adc_block",
+    [EV_UART_LINE] = "uart_line",
+};
+
+void evbus_report(fmt_putc_t putc) {
+    fmt_put_str(putc, "[EVBUS] tipo: eventos descartes lat_max lat_media (ciclos) subs\r\n");
+    for (uint32_t t = 0; t < EV_TYPES; ++t) {
+        const evbus_stats_t *st = &evbus_stats[t];
+        fmt_put_str(putc, "  ");
+        fmt_put_str(putc, evbus_names[t]);
+        fmt_put_str(putc, ": ");
+        fmt_put_u32(putc, st->posted);
+        putc(' ');
+        fmt_put_u32(putc, st->dropped);
+        putc(' ');
+        fmt_put_u32(putc, st->lat_max);
+        putc(' ');
+        fmt_put_u32(putc, st->dispatched ? (uint32_t)(st->lat_sum / st->dispatched) : 0U);
+        putc(' ');
+        fmt_put_u32(putc, (uint32_t)(evbus_first[t + 1U] - evbus_first[t]));
+        fmt_put_str(putc, "\r\n");
+    }
+}
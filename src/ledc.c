@@ -0,0 +1,126 @@
+/*
+ * ledc.c — PWM por hardware con LEDC (ver ledc.h).
+ *
+ * CONF0/CONF1 del canal se manejan con sombras (regacc.h): ledc_set_duty()
+ * no lee registros por el bus. `make regacc-report` compila este mismo archivo
+ * para el host y cuenta los accesos.
+ */
+
+#include <stdint.h>
+#include "soc.h"
+#include "hot.h"
+#include "ledc.h"
+
+#ifndef DR_REG_LEDC_BASE                      // make bench lo reubica en RAM del simulador
+#define DR_REG_LEDC_BASE        0x60019000UL  // Base bloque LEDC (PWM hardware)
+#endif
+
+#define SYSTEM_LEDC_CLK_EN       BIT(11) // Bit de clock para LEDC
+#define SYSTEM_LEDC_RST          BIT(11) // Bit de reset para LEDC
+
+#define LEDC_LSTIMER0_CONF_REG   (DR_REG_LEDC_BASE + 0x00A0)
+#define LEDC_LSTIMER0_PARA_UP    BIT(25)
+#define LEDC_LSTIMER0_RST        BIT(23)
+#define LEDC_LSTIMER0_PAUSE      BIT(22)
+#define LEDC_CLK_DIV_LSTIMER0_M  ((0x0003FFFFU) << 4)
+#define LEDC_CLK_DIV_LSTIMER0_S  4
+#define LEDC_LSTIMER0_DUTY_RES_M ((0xFU) << 0)
+#define LEDC_LSTIMER0_DUTY_RES_S 0
+
+#define LEDC_CONF_REG            (DR_REG_LEDC_BASE + 0x00D0)
+#define LEDC_CLK_EN              BIT(31)
+#define LEDC_APB_CLK_SEL_M       ((0x3U) << 0)
+#define LEDC_APB_CLK_SEL_S       0
+#define LEDC_APB_CLK_SEL_APB     1U
+
+#define LEDC_LSCH0_CONF0_REG     (DR_REG_LEDC_BASE + 0x0000)
+#define LEDC_PARA_UP_LSCH0       BIT(4)
+#define LEDC_IDLE_LV_LSCH0       BIT(3)
+#define LEDC_SIG_OUT_EN_LSCH0    BIT(2)
+#define LEDC_TIMER_SEL_LSCH0_M   ((0x3U) << 0)
+#define LEDC_TIMER_SEL_LSCH0_S   0
+
+#define LEDC_LSCH0_HPOINT_REG    (DR_REG_LEDC_BASE + 0x0004)
+#define LEDC_LSCH0_DUTY_REG      (DR_REG_LEDC_BASE + 0x0008)
+
+#define LEDC_LSCH0_CONF1_REG     (DR_REG_LEDC_BASE + 0x000C)
+#define LEDC_DUTY_START_LSCH0    BIT(31)
+
+#define GPIO_FUNC3_OUT_SEL_CFG_REG (DR_REG_GPIO_BASE + 0x0560)
+#define GPIO_FUNC3_OEN_INV_SEL      BIT(10)
+#define GPIO_FUNC3_OEN_SEL          BIT(9)
+#define GPIO_FUNC3_OUT_INV_SEL      BIT(8)
+#define GPIO_FUNC3_OUT_SEL_M        ((0xFFU) << 0)
+#define GPIO_FUNC3_OUT_SEL_S        0
+
+#define LEDC_LS_SIG_OUT0_IDX    45U  // Señal PWM canal 0 (low-speed)
+
+#define LEDC_PWM_FREQ_HZ       2000ULL
+#define LEDC_TIMER_SOURCE_HZ   80000000ULL
+#define LEDC_CLK_DIV_FRAC_BITS 8U
+#define LEDC_TIMER_DIVIDER_NUM (LEDC_TIMER_SOURCE_HZ << LEDC_CLK_DIV_FRAC_BITS)
+#define LEDC_TIMER_DIVIDER_DEN (LEDC_PWM_FREQ_HZ * (1ULL << LEDC_TIMER_RES_BITS))
+#define LEDC_TIMER_DIVIDER ((uint32_t)(LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN))
+#define LEDC_DUTY_SHIFT      4U
+
+#if ((LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN) == 0) || ((LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN) > 0x3FFFFU)
+#error "LEDC_TIMER_DIVIDER fuera de rango para el campo de 18 bits"
+#endif
+
+// Sombras en RAM de registros que sólo escribimos (ver regacc.h)
+static reg_shadow_t ledc_ch0_conf0 = REG_SHADOW_INIT(LEDC_LSCH0_CONF0_REG);
+static reg_shadow_t ledc_ch0_conf1 = REG_SHADOW_INIT(LEDC_LSCH0_CONF1_REG);
+
+void ledc_init(void) {
+    // Activar clock/reset de LEDC
+    REG32(SYSTEM_PERIP_CLK_EN0_REG) |= SYSTEM_LEDC_CLK_EN;
+    REG32(SYSTEM_PERIP_RST_EN0_REG) |= SYSTEM_LEDC_RST;
+    REG32(SYSTEM_PERIP_RST_EN0_REG) &= ~SYSTEM_LEDC_RST;
+
+    // Seleccionar reloj APB (80 MHz) y habilitar módulo
+    uint32_t ledc_conf = REG32(LEDC_CONF_REG);
+    ledc_conf |= LEDC_CLK_EN;
+    ledc_conf &= ~LEDC_APB_CLK_SEL_M;
+    ledc_conf |= (LEDC_APB_CLK_SEL_APB << LEDC_APB_CLK_SEL_S);
+    REG32(LEDC_CONF_REG) = ledc_conf;
+
+    // Configurar temporizador low-speed 0: resolución y divisor fraccionario (8 bits fracc.)
+    uint32_t timer_conf = REG32(LEDC_LSTIMER0_CONF_REG);
+    timer_conf &= ~(LEDC_CLK_DIV_LSTIMER0_M | LEDC_LSTIMER0_DUTY_RES_M | LEDC_LSTIMER0_PAUSE);
+    timer_conf |= ((LEDC_TIMER_DIVIDER << LEDC_CLK_DIV_LSTIMER0_S) & LEDC_CLK_DIV_LSTIMER0_M);
+    timer_conf |= ((LEDC_TIMER_RES_BITS << LEDC_LSTIMER0_DUTY_RES_S) & LEDC_LSTIMER0_DUTY_RES_M);
+    REG32(LEDC_LSTIMER0_CONF_REG) = timer_conf;
+    REG32(LEDC_LSTIMER0_CONF_REG) |= LEDC_LSTIMER0_RST;
+    REG32(LEDC_LSTIMER0_CONF_REG) &= ~LEDC_LSTIMER0_RST;
+    REG32(LEDC_LSTIMER0_CONF_REG) |= LEDC_LSTIMER0_PARA_UP;
+
+    // Inicializar canal 0: duty 0, usa timer 0, habilita salida
+    REG32(LEDC_LSCH0_HPOINT_REG) = 0;
+    REG32(LEDC_LSCH0_DUTY_REG) = 0;
+    // Única lectura de CONF0/CONF1: desde aquí ledc_set_duty() trabaja sobre las sombras
+    reg_shadow_load(&ledc_ch0_conf0);
+    reg_shadow_bits(&ledc_ch0_conf0, LEDC_SIG_OUT_EN_LSCH0, // Timer 0 (valor 0)
+                    LEDC_TIMER_SEL_LSCH0_M | LEDC_IDLE_LV_LSCH0 | LEDC_SIG_OUT_EN_LSCH0);
+    reg_shadow_commit(&ledc_ch0_conf0);
+    reg_shadow_pulse(&ledc_ch0_conf0, LEDC_PARA_UP_LSCH0);
+    reg_shadow_load(&ledc_ch0_conf1);
+    reg_shadow_pulse(&ledc_ch0_conf1, LEDC_DUTY_START_LSCH0);
+
+    // Conectar señal LEDC canal 0 a GPIO3
+    uint32_t func3 = REG32(GPIO_FUNC3_OUT_SEL_CFG_REG);
+    func3 &= ~(GPIO_FUNC3_OEN_INV_SEL | GPIO_FUNC3_OEN_SEL | GPIO_FUNC3_OUT_INV_SEL | GPIO_FUNC3_OUT_SEL_M);
+    func3 |= (LEDC_LS_SIG_OUT0_IDX << GPIO_FUNC3_OUT_SEL_S) & GPIO_FUNC3_OUT_SEL_M;
+    REG32(GPIO_FUNC3_OUT_SEL_CFG_REG) = func3;
+
+    ledc_set_duty(0);
+}
+
+HOT_FN void ledc_set_duty(uint32_t duty) {
+    if (duty > LEDC_DUTY_MAX) {
+        duty = LEDC_DUTY_MAX;
+    }
+    REG32(LEDC_LSCH0_DUTY_REG) = duty << LEDC_DUTY_SHIFT;
+    // DUTY_START y PARA_UP se auto-limpian: se escriben desde la sombra, sin RMW por el bus
+    reg_shadow_pulse(&ledc_ch0_conf1, LEDC_DUTY_START_LSCH0);
+    reg_shadow_pulse(&ledc_ch0_conf0, LEDC_PARA_UP_LSCH0);
+}
@@ -1,38 +1,33 @@
 #include <stdint.h>
 #include "wdtfix.h"
+#include "regacc.h"                           // BIT(), REG32(), campos y sombras de registros
+#include "soc.h"                              // Bases GPIO/IO_MUX/SYSTEM compartidas con los drivers
+#include "ledc.h"                             // PWM por hardware (LED en GPIO3)
+#include "uart.h"                             // UART0 por polling
+#include "wdt_supervisor.h"                   // MWDT armado con plazos por tarea
+#include "trace.h"                            // Traza post-mortem en RTC memory
+#include "evbus.h"                            // Bus de eventos: fuentes y handlers por tablas de link
+#include "filter.h"                           // Filtros enteros para bloques del ADC
+
+/* Mantiene un segmento .rodata pequeño para el enlace en DROM (una sola copia). */
+static const char app_banner[] __attribute__((used)) = "ESP32-C3 baremetal demo";
 
-#define BIT(n) (1U << (n))                    // Máscara de un bit
-#define REG32(addr) (*(volatile uint32_t *)(addr)) // Acceso directo a registro de 32 bits
-
-#define DR_REG_GPIO_BASE        0x60004000UL  // Base periférico GPIO
-#define DR_REG_IO_MUX_BASE      0x60009000UL  // Base IO_MUX (selección de función/pulls)
-#define DR_REG_SYSTEM_BASE      0x600C0000UL  // Base registro de sistema (clocks/resets)
 #define DR_REG_APB_SARADC_BASE  0x60040000UL  // Base ADC SAR digital
-#define DR_REG_LEDC_BASE        0x60019000UL  // Base bloque LEDC (PWM hardware)
 
 #define GPIO_OUT_W1TS_REG   (DR_REG_GPIO_BASE + 0x0008)  // Set pin high (write-1-to-set)
 #define GPIO_OUT_W1TC_REG   (DR_REG_GPIO_BASE + 0x000C)  // Set pin low  (write-1-to-clear)
-#define GPIO_ENABLE_W1TS_REG (DR_REG_GPIO_BASE + 0x0024) // Habilitar OE
-#define GPIO_ENABLE_W1TC_REG (DR_REG_GPIO_BASE + 0x0028) // Deshabilitar OE
 
 #define GPIO_IN_REG         (DR_REG_GPIO_BASE + 0x003C)   // <--- REGISTRO DE ENTRADA GPIO
 
 #define IO_MUX_GPIO0_REG    (DR_REG_IO_MUX_BASE + 0x0004) // IO_MUX para GPIO0 (ADC)
 #define IO_MUX_GPIO3_REG    (DR_REG_IO_MUX_BASE + 0x0010) // IO_MUX para GPIO3 (LED)
-#define IO_MUX_FUN_IE       BIT(9)   // Input enable digital
-#define IO_MUX_FUN_PU       BIT(8)   // Pull-up digital
-#define IO_MUX_FUN_PD       BIT(7)   // Pull-down digital
-#define IO_MUX_MCU_SEL_MASK (0x7U << 12) // Selector de función
-#define IO_MUX_MCU_SEL_GPIO 1U       // Función GPIO
 #define IO_MUX_GPIO2_REG        (DR_REG_IO_MUX_BASE + 0x000C)
 #define IO_MUX_GPIO4_REG        (DR_REG_IO_MUX_BASE + 0x0014)
+#define GPIO_FUNC4_OUT_SEL_CFG_REG (DR_REG_GPIO_BASE + 0x0564) // Selector de salida de GPIO4
+#define GPIO_OUT_SEL_SIMPLE     0x80U   // Salida simple: el pin sigue a GPIO_OUT
 
-#define SYSTEM_PERIP_CLK_EN0_REG (DR_REG_SYSTEM_BASE + 0x0010) // Registro de clocks
-#define SYSTEM_PERIP_RST_EN0_REG (DR_REG_SYSTEM_BASE + 0x0018) // Registro de resets
 #define SYSTEM_APB_SARADC_CLK_EN BIT(28) // Bit de clock para ADC SAR
 #define SYSTEM_APB_SARADC_RST    BIT(28) // Bit de reset para ADC SAR
-#define SYSTEM_LEDC_CLK_EN       BIT(11) // Bit de clock para LEDC
-#define SYSTEM_LEDC_RST          BIT(11) // Bit de reset para LEDC
 
 #define APB_SARADC_CTRL_REG            (DR_REG_APB_SARADC_BASE + 0x0000) // Control general ADC
 #define APB_SARADC_START_FORCE         BIT(0)  // Forzar arranque digital
@@ -60,42 +55,6 @@
 #define APB_SARADC_INT_CLR_REG         (DR_REG_APB_SARADC_BASE + 0x004C) // Clear de flags
 #define APB_SARADC_ADC1_DONE_INT_CLR   BIT(31) // Limpia flag done
 
-#define LEDC_LSTIMER0_CONF_REG   (DR_REG_LEDC_BASE + 0x00A0)
-#define LEDC_LSTIMER0_PARA_UP    BIT(25)
-#define LEDC_LSTIMER0_RST        BIT(23)
-#define LEDC_LSTIMER0_PAUSE      BIT(22)
-#define LEDC_CLK_DIV_LSTIMER0_M  ((0x0003FFFFU) << 4)
-#define LEDC_CLK_DIV_LSTIMER0_S  4
-#define LEDC_LSTIMER0_DUTY_RES_M ((0xFU) << 0)
-#define LEDC_LSTIMER0_DUTY_RES_S 0
-
-#define LEDC_CONF_REG            (DR_REG_LEDC_BASE + 0x00D0)
-#define LEDC_CLK_EN              BIT(31)
-#define LEDC_APB_CLK_SEL_M       ((0x3U) << 0)
-#define LEDC_APB_CLK_SEL_S       0
-#define LEDC_APB_CLK_SEL_APB     1U
-
-#define LEDC_LSCH0_CONF0_REG     (DR_REG_LEDC_BASE + 0x0000)
-#define LEDC_PARA_UP_LSCH0       BIT(4)
-#define LEDC_IDLE_LV_LSCH0       BIT(3)
-#define LEDC_SIG_OUT_EN_LSCH0    BIT(2)
-#define LEDC_TIMER_SEL_LSCH0_M   ((0x3U) << 0)
-#define LEDC_TIMER_SEL_LSCH0_S   0
-
-#define LEDC_LSCH0_HPOINT_REG    (DR_REG_LEDC_BASE + 0x0004)
-#define LEDC_LSCH0_DUTY_REG      (DR_REG_LEDC_BASE + 0x0008)
-
-#define LEDC_LSCH0_CONF1_REG     (DR_REG_LEDC_BASE + 0x000C)
-#define LEDC_DUTY_START_LSCH0    BIT(31)
-
-#define GPIO_FUNC3_OUT_SEL_CFG_REG (DR_REG_GPIO_BASE + 0x0560)
-#define GPIO_FUNC3_OEN_INV_SEL      BIT(10)
-#define GPIO_FUNC3_OEN_SEL          BIT(9)
-#define GPIO_FUNC3_OUT_INV_SEL      BIT(8)
-#define GPIO_FUNC3_OUT_SEL_M        ((0xFFU) << 0)
-#define GPIO_FUNC3_OUT_SEL_S        0
-
-#define LEDC_LS_SIG_OUT0_IDX    45U  // Señal PWM canal 0 (low-speed)
 
 #define LED_GPIO        3U
 #define LED2_GPIO       5U
@@ -119,84 +78,64 @@
 #define ADC_THRESHOLD   2000U
 #define LOOP_DELAY      5000U
 
-#define ADC_ZERO_BIAS   1650U   // Cuentas residuales con cursor a GND (ajustar según hardware)
-
-#define LEDC_PWM_FREQ_HZ       2000ULL
-#define LEDC_TIMER_RES_BITS    10U
-#define LEDC_TIMER_SOURCE_HZ   80000000ULL
-#define LEDC_CLK_DIV_FRAC_BITS 8U
-#define LEDC_TIMER_DIVIDER_NUM (LEDC_TIMER_SOURCE_HZ << LEDC_CLK_DIV_FRAC_BITS)
-#define LEDC_TIMER_DIVIDER_DEN (LEDC_PWM_FREQ_HZ * (1ULL << LEDC_TIMER_RES_BITS))
-#define LEDC_TIMER_DIVIDER ((uint32_t)(LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN))
-#define LEDC_DUTY_MAX        ((1U << LEDC_TIMER_RES_BITS) - 1U)
-#define LEDC_DUTY_SHIFT      4U
-
-#if ((LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN) == 0) || ((LEDC_TIMER_DIVIDER_NUM / LEDC_TIMER_DIVIDER_DEN) > 0x3FFFFU)
-#error "LEDC_TIMER_DIVIDER fuera de rango para el campo de 18 bits"
+// Supervisor de watchdog: IDs de tarea y plazos (ver wdt_supervisor.h)
+#define TASK_SENSOR           0U
+#define TASK_ACTUATOR         1U
+#define SENSOR_DEADLINE_US    30000U  // Cubre un eco completo del HC-SR04 (~25 ms)
+#define ACTUATOR_DEADLINE_US  10000U  // PWM + mensaje UART (~4 ms a 115200 con FIFO llena)
+#define WDT_TIMEOUT_MS        500U    // Sin check-in de todas las tareas -> stage 0
+
+// Variante de arranque (make BOOT=direct define BOOT_DIRECT)
+#ifdef BOOT_DIRECT
+#define BOOT_VARIANT "direct"
+#else
+#define BOOT_VARIANT "idf"
 #endif
 
+// Eventos de traza de la aplicación (ver trace.h)
+#define TRACE_EV_BUTTON       (TRACE_EV_APP + 0U)  // a0 = nivel nuevo, a1 = duty actual
 
-#define DR_REG_UART_BASE(i)     (0x60000000UL + (0x1000 * (i))) // Base para UART0 (i=0) y UART1 (i=1)
-
-#define DR_REG_UART0_BASE       DR_REG_UART_BASE(0) // 0x60000000
-
-#define UART_CLK_DIV_REG(i)     (DR_REG_UART_BASE(i) + 0x0014) // Divisor de clock (baud rate)
-#define UART_FIFO_REG(i)        (DR_REG_UART_BASE(i) + 0x0000) // Registro de datos/FIFO
-
-#define UART_STATUS_REG(i)      (DR_REG_UART_BASE(i) + 0x001C) // Registro de estado (para TX)
-#define UART_TXFIFO_CNT_S       16 // Shift para contador FIFO
-#define UART_TXFIFO_CNT_M       (0x1FFU << UART_TXFIFO_CNT_S)  // Máscara
-#define UART_FIFO_SIZE          0x7FU // Tamaño del FIFO (128 bytes)
+// Bloques del ADC publicados en el bus (sólo con SENSOR_HCSR04: ajustan el umbral del eco)
+#define ADC_BLOCK_SAMPLES     16U     // 32 bytes: cabe en un buffer del pool
+#define ADC_BLOCK_PERIOD      64U     // Iteraciones del bucle entre bloques
+#define ADC_EMA_SHIFT         2U      // alfa = 1/4 sobre las medias de bloque
 
-#define SYSTEM_UART_CLK_EN(i)   (1U << (i))       // i=0 para UART0, i=1 para UART1
-#define SYSTEM_UART_RST(i)      (1U << (i))
-
-// Base y Máscaras
-#define GPIO_FUNC_OUT_SEL_S     0       // Shift para el selector de función de salida
-#define IO_MUX_MCU_SEL_V        1U      // Valor 1 para seleccionar GPIO matrix (no función default)
-
-// Registros de la matriz de función (para conectar UART0 a GPIOs)
-#define GPIO_FUNC21_OUT_SEL_CFG_REG (DR_REG_GPIO_BASE + 0x05BC) // Registro de salida para GPIO21
-#define GPIO_FUNC20_IN_SEL_CFG_REG  (DR_REG_GPIO_BASE + 0x05CC) // Registro de entrada para GPIO20
+#if (ADC_BLOCK_SAMPLES * 2U) > EVBUS_BUF_SIZE
+#error "ADC_BLOCK_SAMPLES no entra en un buffer del bus"
+#endif
 
-// Índices de la señal UART0 en la matriz
-#define U0TXD_OUT_IDX                  0x00U  // Índice de la señal U0TXD
-#define U0RXD_IN_IDX                   0x00U  // Índice de la señal U0RXD (este es el default, pero lo ponemos)
+#define ADC_ZERO_BIAS   1650U   // Cuentas residuales con cursor a GND (ajustar según hardware)
 
-// Registros IO_MUX específicos para GPIO21 y GPIO20
-#define IO_MUX_GPIO21_REG       (DR_REG_IO_MUX_BASE + 0x0058)
-#define IO_MUX_GPIO20_REG       (DR_REG_IO_MUX_BASE + 0x0054)
 
-// Definiciones adicionales para GPIO/IO_MUX para asignar pines
-#define UART0_TX_GPIO 21U
-#define UART0_RX_GPIO 20U
-#define UART0_TX_OUT_IDX 0x00U // Seleccion de funcion de salida
-#define UART0_RX_IN_IDX 0x00U  // Seleccion de funcion de entrada
 
-//TIMER
-#define DR_REG_TIMG_BASE(i)     (0x60082000UL + (0x1000 * (i)))
-#define DR_REG_TIMG0_BASE       DR_REG_TIMG_BASE(0) // Base del Timer Group 0
 
-#define TIMG_T0CONFIG_REG       (DR_REG_TIMG0_BASE + 0x0000)
+//TIMER (T0 del Timer Group 0; TIMG0_BASE = 0x6001F000 en wdtfix.h)
+#define TIMG_T0CONFIG_REG       (TIMG0_BASE + 0x0000)
 #define TIMG_T0_EN              BIT(31)     // Habilitar Timer
-#define TIMG_T0_DIVIDER_S       16          // Shift para el divisor de clock
-#define TIMG_T0_INCREASE        BIT(13)     // Contar hacia arriba
-#define TIMG_T0_AUTORELOAD      BIT(19)     // Deshabilitamos autoreload
-#define TIMG_T0_CLK_SRC_S        29          // Shift Clock Source
+#define TIMG_T0_INCREASE        BIT(30)     // Contar hacia arriba
+#define TIMG_T0_AUTORELOAD      BIT(29)     // Deshabilitamos autoreload
+#define TIMG_T0_DIVIDER_S       13          // Shift para el divisor de clock (16 bits)
+#define TIMG_T0_USE_XTAL        BIT(9)      // Clock fuente: XTAL en vez de APB
+
+#define TIMG_T0_CNT_LOW_REG     (TIMG0_BASE + 0x0004) // Leer contador bajo (32 bits)
+#define TIMG_T0_CNT_HIGH_REG    (TIMG0_BASE + 0x0008) // Leer contador alto (22 bits)
+#define TIMG_T0_UPDATE_REG      (TIMG0_BASE + 0x000C) // Copiar el contador a LO/HI
+#define TIMG_T0_UPDATE          BIT(31)
+#define TIMG_T0LOAD_LOW_REG     (TIMG0_BASE + 0x0018) // Valor de recarga (bajo)
+#define TIMG_T0LOAD_HIGH_REG    (TIMG0_BASE + 0x001C) // Valor de recarga (alto)
+#define TIMG_T0LOAD_REG         (TIMG0_BASE + 0x0020) // Escribir cualquier valor recarga
 
-#define TIMG_T0LOAD_REG         (DR_REG_TIMG0_BASE + 0x0008) // Cargar valor inicial
-#define TIMG_T0LOAD_LOW_REG     (DR_REG_TIMG0_BASE + 0x0004) // Contador bajo (32 bits)
-#define TIMG_T0LOAD_HIGH_REG    (DR_REG_TIMG0_BASE + 0x000c) // Contador alto (16 bits)
-#define TIMG_T0_UPDATE_REG      (DR_REG_TIMG0_BASE + 0x0010) // Forzar actualización de lectura
-#define TIMG_T0_LOAD_EN         BIT(31)     // Habilitar la carga
+// Clock fuente XTAL (40 MHz): no depende del APB que dejó el arranque
+#define TIMG_DIVIDER_US         40U         // 40 MHz / 40 = 1 MHz (1 tick = 1 µs)
 
-#define TIMG_T0_CNT_LOW_REG     (DR_REG_TIMG0_BASE + 0x0004) // Leer contador bajo
-#define TIMG_T0_CNT_HIGH_REG    (DR_REG_TIMG0_BASE + 0x000c) // Leer contador alto
 
-// Clock fuente es APB_CLK (80 MHz)
-#define TIMG_DIVIDER_US         80U         // 80 MHz / 80 = 1 MHz (1 tick = 1 µs)
+// Marcas de tiempo tomadas por startup.S al entrar a _start
+extern uint32_t boot_cycles;      // Contador de ciclos de CPU (PCCR) desde el reset
+extern uint32_t boot_rtc_ticks;   // Timer RTC (reloj lento) desde el power-on
 
-static void ledc_set_duty(uint32_t duty);
+#ifdef SENSOR_HCSR04
+static uint64_t timer_get_us(void);
+#endif
 
 static void gpio_init(void) {
     // GPIO3 queda como salida controlada por LEDC (sin pulls, función GPIO)
@@ -236,16 +175,21 @@ static void gpio_init(void) {
     // Deshabilitar OE: ECHO/BUTTON (GPIO2) debe ser una entrada pura
     //REG32(GPIO_ENABLE_W1TC_REG) = ECHO_MASK;
 
-    // ECHO en GPIO4 (entrada)
+#ifdef SENSOR_HCSR04
+    // TRIG en GPIO4: salida simple (GPIO_OUT), arranca en bajo. ECHO usa GPIO2,
+    // ya configurado arriba como entrada (con el sensor no se lee el botón).
     reg = REG32(IO_MUX_GPIO4_REG);
-    reg &= ~(IO_MUX_FUN_PU | IO_MUX_FUN_PD | IO_MUX_MCU_SEL_MASK);
-    reg |= IO_MUX_FUN_IE;                      // habilitar entrada digital
+    reg &= ~(IO_MUX_FUN_IE | IO_MUX_FUN_PU | IO_MUX_FUN_PD | IO_MUX_MCU_SEL_MASK);
     reg |= (IO_MUX_MCU_SEL_GPIO << 12);
     REG32(IO_MUX_GPIO4_REG) = reg;
-    REG32(GPIO_ENABLE_W1TC_REG) = ECHO_MASK;   // asegurar que NO sea salida
+    REG32(GPIO_FUNC4_OUT_SEL_CFG_REG) = GPIO_OUT_SEL_SIMPLE;
+    REG32(GPIO_OUT_W1TC_REG) = TRIG_MASK;
+    REG32(GPIO_ENABLE_W1TS_REG) = TRIG_MASK;   // habilitar OE: si no, el pulso no sale
+#endif
 
 }
 
+#ifdef SENSOR_HCSR04   // Sólo lo usa la fuente de eco (make SENSOR_HCSR04=1)
 // ----------------------------------------
 // Medir pulso del HC-SR04 (ECHO)
 // Devuelve "cuántas iteraciones" estuvo en alto
@@ -297,7 +241,16 @@ static uint32_t hcsr04_measure_pulse(void) {
     uint64_t end_time = 0;
     uint32_t timeout = 0; // Usaremos el timeout para prevenir bucles infinitos
 
-    // ... (Generación del pulso TRIG y tiny_delay se mantienen igual) ...
+    // Asegurar TRIG en bajo
+    REG32(GPIO_OUT_W1TC_REG) = TRIG_MASK;
+    tiny_delay();
+
+    // Pulso de 10µs aprox en TRIG: sin él el HC-SR04 nunca emite el eco
+    REG32(GPIO_OUT_W1TS_REG) = TRIG_MASK;
+    for (volatile uint32_t i = 0; i < 2000; ++i) {
+        __asm__ volatile("nop");
+    }
+    REG32(GPIO_OUT_W1TC_REG) = TRIG_MASK;
 
     // Esperar a que ECHO se ponga en alto (inicio pulso)
     while (((REG32(GPIO_IN_REG) & ECHO_MASK) == 0U) && (timeout < HCSR04_TIMEOUT)) {
@@ -325,6 +278,7 @@ static uint32_t hcsr04_measure_pulse(void) {
     // Devolver la duración del pulso en µs
     return (uint32_t)(end_time - start_time);
 }
+#endif
 
 static void adc_init(void) {
     // Clock/reset del SARADC
@@ -357,50 +311,8 @@ static void adc_init(void) {
     REG32(APB_SARADC_INT_CLR_REG) = APB_SARADC_ADC1_DONE_INT_CLR;
 }
 
-static void ledc_init(void) {
-    // Activar clock/reset de LEDC
-    REG32(SYSTEM_PERIP_CLK_EN0_REG) |= SYSTEM_LEDC_CLK_EN;
-    REG32(SYSTEM_PERIP_RST_EN0_REG) |= SYSTEM_LEDC_RST;
-    REG32(SYSTEM_PERIP_RST_EN0_REG) &= ~SYSTEM_LEDC_RST;
-
-    // Seleccionar reloj APB (80 MHz) y habilitar módulo
-    uint32_t ledc_conf = REG32(LEDC_CONF_REG);
-    ledc_conf |= LEDC_CLK_EN;
-    ledc_conf &= ~LEDC_APB_CLK_SEL_M;
-    ledc_conf |= (LEDC_APB_CLK_SEL_APB << LEDC_APB_CLK_SEL_S);
-    REG32(LEDC_CONF_REG) = ledc_conf;
-
-    // Configurar temporizador low-speed 0: resolución y divisor fraccionario (8 bits fracc.)
-    uint32_t timer_conf = REG32(LEDC_LSTIMER0_CONF_REG);
-    timer_conf &= ~(LEDC_CLK_DIV_LSTIMER0_M | LEDC_LSTIMER0_DUTY_RES_M | LEDC_LSTIMER0_PAUSE);
-    timer_conf |= ((LEDC_TIMER_DIVIDER << LEDC_CLK_DIV_LSTIMER0_S) & LEDC_CLK_DIV_LSTIMER0_M);
-    timer_conf |= ((LEDC_TIMER_RES_BITS << LEDC_LSTIMER0_DUTY_RES_S) & LEDC_LSTIMER0_DUTY_RES_M);
-    REG32(LEDC_LSTIMER0_CONF_REG) = timer_conf;
-    REG32(LEDC_LSTIMER0_CONF_REG) |= LEDC_LSTIMER0_RST;
-    REG32(LEDC_LSTIMER0_CONF_REG) &= ~LEDC_LSTIMER0_RST;
-    REG32(LEDC_LSTIMER0_CONF_REG) |= LEDC_LSTIMER0_PARA_UP;
-
-    // Inicializar canal 0: duty 0, usa timer 0, habilita salida
-    REG32(LEDC_LSCH0_HPOINT_REG) = 0;
-    REG32(LEDC_LSCH0_DUTY_REG) = 0;
-    uint32_t ch0_conf0 = REG32(LEDC_LSCH0_CONF0_REG);
-    ch0_conf0 &= ~(LEDC_TIMER_SEL_LSCH0_M | LEDC_IDLE_LV_LSCH0 | LEDC_SIG_OUT_EN_LSCH0);
-    ch0_conf0 |= LEDC_SIG_OUT_EN_LSCH0; // Timer 0 (valor 0)
-    REG32(LEDC_LSCH0_CONF0_REG) = ch0_conf0;
-    REG32(LEDC_LSCH0_CONF0_REG) |= LEDC_PARA_UP_LSCH0;
-    uint32_t ch0_conf1 = REG32(LEDC_LSCH0_CONF1_REG);
-    ch0_conf1 |= LEDC_DUTY_START_LSCH0;
-    REG32(LEDC_LSCH0_CONF1_REG) = ch0_conf1;
-
-    // Conectar señal LEDC canal 0 a GPIO3
-    uint32_t func3 = REG32(GPIO_FUNC3_OUT_SEL_CFG_REG);
-    func3 &= ~(GPIO_FUNC3_OEN_INV_SEL | GPIO_FUNC3_OEN_SEL | GPIO_FUNC3_OUT_INV_SEL | GPIO_FUNC3_OUT_SEL_M);
-    func3 |= (LEDC_LS_SIG_OUT0_IDX << GPIO_FUNC3_OUT_SEL_S) & GPIO_FUNC3_OUT_SEL_M;
-    REG32(GPIO_FUNC3_OUT_SEL_CFG_REG) = func3;
-
-    ledc_set_duty(0);
-}
 
+#ifdef SENSOR_HCSR04   // Sólo lo usa la fuente de bloques del ADC
 static uint16_t adc_sample_once(void) {
     // Pulso de start (low→high) para disparar conversión oneshot
     uint32_t sample = REG32(APB_SARADC_ONETIME_SAMPLE_REG);
@@ -420,6 +332,7 @@ static uint16_t adc_sample_once(void) {
     REG32(APB_SARADC_INT_CLR_REG) = APB_SARADC_ADC1_DONE_INT_CLR;
     return (uint16_t)(raw & 0x0FFFU);
 }
+#endif
 
 static void short_delay(void) {
     // Busy-wait simple (no timers configurados)
@@ -428,71 +341,14 @@ static void short_delay(void) {
     }
 }
 
-static void ledc_set_duty(uint32_t duty) {
-    if (duty > LEDC_DUTY_MAX) {
-        duty = LEDC_DUTY_MAX;
-    }
-    REG32(LEDC_LSCH0_DUTY_REG) = duty << LEDC_DUTY_SHIFT;
-    REG32(LEDC_LSCH0_CONF1_REG) |= LEDC_DUTY_START_LSCH0;
-    REG32(LEDC_LSCH0_CONF0_REG) |= LEDC_PARA_UP_LSCH0;
-}
-
-static void uart_init(void) {
-    // --- 1. Activar Clock y Reset UART0 ---
-    REG32(SYSTEM_PERIP_CLK_EN0_REG) |= SYSTEM_UART_CLK_EN(0);
-    REG32(SYSTEM_PERIP_RST_EN0_REG) |= SYSTEM_UART_RST(0);
-    REG32(SYSTEM_PERIP_RST_EN0_REG) &= ~SYSTEM_UART_RST(0);
-
-    // --- 2. Configurar Baud Rate (115200) ---
-    // Divisor = 40MHz / 115200 = 347.22 (usamos 347, que es 0x15B)
-    REG32(UART_CLK_DIV_REG(0)) = (347U << 4); 
-
-    // --- 3. Configurar Pines (GPIO21=TX, GPIO20=RX) ---
-    
-    // 3a. Mapear UART0 TX a GPIO21
-    // Conectar U0TXD_OUT_IDX (0x00) al GPIO21
-    REG32(GPIO_FUNC21_OUT_SEL_CFG_REG) = (U0TXD_OUT_IDX << GPIO_FUNC_OUT_SEL_S);
-    // Habilitar la salida (OE) para GPIO21
-    REG32(GPIO_ENABLE_W1TS_REG) = BIT(UART0_TX_GPIO);
-    // Configurar IO_MUX para usar la Matriz GPIO
-    REG32(IO_MUX_GPIO21_REG) &= ~(IO_MUX_MCU_SEL_MASK); 
-    REG32(IO_MUX_GPIO21_REG) |= (IO_MUX_MCU_SEL_V << 12); 
-
-    // 3b. Mapear UART0 RX a GPIO20
-    // Conectar U0RXD_IN_IDX (0x00) al GPIO20 (con el bit de habilitación de entrada)
-    REG32(GPIO_FUNC20_IN_SEL_CFG_REG) = (U0RXD_IN_IDX << GPIO_FUNC_OUT_SEL_S) | IO_MUX_FUN_IE;
-    // Deshabilitar la salida (OE) para GPIO20
-    REG32(GPIO_ENABLE_W1TC_REG) = BIT(UART0_RX_GPIO);
-    // Configurar IO_MUX para usar la Matriz GPIO
-    REG32(IO_MUX_GPIO20_REG) &= ~(IO_MUX_MCU_SEL_MASK);
-    REG32(IO_MUX_GPIO20_REG) |= (IO_MUX_MCU_SEL_V << 12); 
-    
-    // Nota: Configuración de palabra (8 bits, sin paridad, 1 bit de parada) es el default y se omite por simplicidad.
-}
-
-static void uart_putc(char c) {
-    // Esperar hasta que el FIFO no esté lleno
-    while ((REG32(UART_STATUS_REG(0)) & UART_TXFIFO_CNT_M) >= (UART_FIFO_SIZE << UART_TXFIFO_CNT_S)) {
-        // Busy-wait
-        __asm__ volatile("nop");
-    }
-    
-    // Escribir el carácter al registro FIFO (dirección 0x60000000)
-    REG32(UART_FIFO_REG(0)) = (uint32_t)c;
-}
 
-static void uart_puts(const char *s) {
-    while (*s) {
-        uart_putc(*s++);
-    }
-}
 
 static void timer_init(void) {
     // 1. Deshabilitar Timer y limpiar la configuración
     REG32(TIMG_T0CONFIG_REG) &= ~TIMG_T0_EN; 
     
-    // 2. Configurar el divisor para 1 µs por tick (80 MHz / 80 = 1 MHz)
-    uint32_t config = 0;
+    // 2. Configurar el divisor para 1 µs por tick (XTAL 40 MHz / 40 = 1 MHz)
+    uint32_t config = TIMG_T0_USE_XTAL;
     config |= (TIMG_DIVIDER_US << TIMG_T0_DIVIDER_S);
     
     // 3. Configurar: conteo ascendente (INCREASE), sin autoreload
@@ -503,30 +359,195 @@ static void timer_init(void) {
     REG32(TIMG_T0CONFIG_REG) = config;
     
     // 5. Cargar valor inicial 0 al contador (solo para asegurar)
-    REG32(TIMG_T0LOAD_REG) = 0; 
-    REG32(TIMG_T0LOAD_REG) = 0; // Se escribe dos veces para 64-bit
-    REG32(TIMG_T0LOAD_REG) = TIMG_T0_LOAD_EN;
+    REG32(TIMG_T0LOAD_LOW_REG) = 0;
+    REG32(TIMG_T0LOAD_HIGH_REG) = 0;
+    REG32(TIMG_T0LOAD_REG) = 1U;    // Dispara la recarga
     
     // 6. Habilitar el Timer
     REG32(TIMG_T0CONFIG_REG) |= TIMG_T0_EN; 
 }
 
+#ifdef SENSOR_HCSR04
 static uint64_t timer_get_us(void) {
     // 1. Forzar la actualización de los registros de lectura
-    REG32(TIMG_T0_UPDATE_REG) = TIMG_T0_LOAD_EN; 
+    REG32(TIMG_T0_UPDATE_REG) = TIMG_T0_UPDATE;
     
     // 2. Leer los 32 bits bajos (µs)
     uint32_t low = REG32(TIMG_T0_CNT_LOW_REG);
     
-    // 3. Leer los 16 bits altos (los bits restantes, aunque no serán necesarios para el HC-SR04)
+    // 3. Leer los 22 bits altos (los bits restantes, aunque no serán necesarios para el HC-SR04)
     uint32_t high = REG32(TIMG_T0_CNT_HIGH_REG);
     
     // 4. Combinar y devolver el resultado en µs
     return ((uint64_t)high << 32) | low;
 }
+#endif
+
+static void boot_report(void) {
+    // Tiempo desde el reset hasta _start: permite comparar BOOT=idf vs BOOT=direct
+    uart_puts("[BOOT] variante " BOOT_VARIANT ": ciclos=");
+    fmt_put_u32(uart_putc, boot_cycles);
+    uart_puts(" rtc_ticks=");
+    fmt_put_u32(uart_putc, boot_rtc_ticks);
+    uart_puts("\r\n");
+}
+
+// ---------------------------------------------------------------------------
+// Fuentes de eventos (drivers). Se registran con EVBUS_SOURCE y las recorre
+// evbus_poll_sources(); los datos van a buffers del pool, sin copias.
+// ---------------------------------------------------------------------------
+static void tick_source(void) {
+    static uint32_t ticks;
+    evbus_post(EV_TICK, ticks++, EVBUS_NO_BUF, 0U);
+}
+EVBUS_SOURCE(tick_source);
+
+#ifndef SENSOR_HCSR04   // Con el sensor, GPIO2 es el ECHO: sus pulsos no son flancos del botón
+static void button_source(void) {
+    static uint32_t last_button;
+    // 🔥 Leer GPIO2 digital: sólo se publica el flanco
+    uint32_t button = (REG32(GPIO_IN_REG) & BUTTON_MASK) != 0U;
+    if (button != last_button) {
+        last_button = button;
+        evbus_post(EV_BUTTON, button, EVBUS_NO_BUF, 0U);
+    }
+}
+EVBUS_SOURCE(button_source);
+#endif
+
+static void uart_rx_source(void) {
+    static uint32_t uart_rx_buf = EVBUS_NO_BUF;   // Línea en armado (buffer del pool)
+    static uint32_t uart_rx_len;
+    uint32_t avail = uart_rx_count();
+    while (avail--) {
+        char c = uart_rx_byte();
+        if (uart_rx_buf == EVBUS_NO_BUF) {
+            uart_rx_buf = evbus_alloc();
+            uart_rx_len = 0U;
+            if (uart_rx_buf == EVBUS_NO_BUF) {
+                continue;   // Pool agotado: se pierde el carácter
+            }
+        }
+        if (c == '\r' || c == '\n') {
+            if (uart_rx_len > 0U) {
+                evbus_post(EV_UART_LINE, 0U, uart_rx_buf, uart_rx_len);
+                uart_rx_buf = EVBUS_NO_BUF;
+            }
+            continue;
+        }
+        if (uart_rx_len < EVBUS_BUF_SIZE) {
+            evbus_buf(uart_rx_buf)[uart_rx_len++] = (uint8_t)c;   // Se trunca lo que no entra
+        }
+    }
+}
+EVBUS_SOURCE(uart_rx_source);
+
+#ifdef SENSOR_HCSR04
+static void echo_source(void) {
+    uint32_t pulse = hcsr04_measure_pulse();
+    if (pulse != 0U) {
+        evbus_post(EV_ECHO, pulse, EVBUS_NO_BUF, 0U);
+    }
+}
+EVBUS_SOURCE(echo_source);
+
+static void adc_block_source(void) {
+    static uint32_t ticks;
+    if (++ticks < ADC_BLOCK_PERIOD) {
+        return;
+    }
+    uint32_t buf = evbus_alloc();
+    if (buf == EVBUS_NO_BUF) {
+        return;     // Se reintenta en la próxima iteración
+    }
+    ticks = 0U;
+    // Las muestras se escriben directamente en el buffer que recibirán los handlers
+    uint16_t *samples = (uint16_t *)evbus_buf(buf);
+    for (uint32_t i = 0; i < ADC_BLOCK_SAMPLES; ++i) {
+        samples[i] = adc_sample_once();
+    }
+    evbus_post(EV_ADC_BLOCK, 0U, buf, ADC_BLOCK_SAMPLES * sizeof(uint16_t));
+}
+EVBUS_SOURCE(adc_block_source);
+#endif
+
+// ---------------------------------------------------------------------------
+// Handlers (consumidores). Se registran con EVBUS_SUBSCRIBE por tipo de evento.
+// ---------------------------------------------------------------------------
+static uint32_t fade_duty;
+static int8_t fade_step = 1;
+static uint32_t hold_button;        // Botón en alto -> LED detiene el fade
+static uint32_t hold_echo;          // Objeto "cerca" -> LED detiene el fade
+static uint32_t echo_threshold = HCSR04_NEAR_THRESHOLD;
+static filter_ema_t adc_filter;
+static uint32_t adc_filter_ready;
+
+static void on_tick_fade(const evbus_event_t *ev) {
+    (void)ev;
+    ledc_set_duty(fade_duty);
+    if (hold_button || hold_echo) {
+        return;
+    }
+    fade_duty += fade_step;
+    if (fade_duty == LEDC_DUTY_MAX || fade_duty == 0) {
+        fade_step = -fade_step; // Cambio de dirección
+    }
+}
+EVBUS_SUBSCRIBE(EV_TICK, on_tick_fade);
+
+static void on_button(const evbus_event_t *ev) {
+    hold_button = ev->arg;
+    trace_event(TRACE_EV_BUTTON, ev->arg, fade_duty);
+    if (ev->arg) {
+        // \r\n (Carriage Return + New Line) es importante para saltos de línea
+        uart_puts("!ATENCION: Deteccion activada. LED detenido.\r\n");
+    }
+}
+EVBUS_SUBSCRIBE(EV_BUTTON, on_button);
+
+static void on_echo(const evbus_event_t *ev) {
+    // Pulso mayor que el umbral dinámico -> objeto "cerca"
+    hold_echo = ev->arg > echo_threshold;
+}
+EVBUS_SUBSCRIBE(EV_ECHO, on_echo);
+
+static void on_adc_block(const evbus_event_t *ev) {
+    // Se lee el bloque en el buffer del pool (sin copiarlo)
+    const uint16_t *samples = (const uint16_t *)evbus_payload(ev);
+    uint16_t avg = filter_block_avg(samples, ev->len / sizeof(uint16_t));
+    if (!adc_filter_ready) {
+        filter_ema_init(&adc_filter, avg, ADC_EMA_SHIFT);
+        adc_filter_ready = 1U;
+    }
+    uint16_t raw_adc = filter_ema_step(&adc_filter, avg);
+
+    // Mapear el ADC (0-4095) a un OFFSET de 0 a 3000 µs sobre el umbral base
+    echo_threshold = HCSR04_NEAR_THRESHOLD + (raw_adc * 3000U / 4095U);
+}
+EVBUS_SUBSCRIBE(EV_ADC_BLOCK, on_adc_block);
+
+static void on_uart_line(const evbus_event_t *ev) {
+    const uint8_t *line = evbus_payload(ev);
+    static const char cmd_stats[] = "stats";
+    uint32_t is_stats = (ev->len == sizeof(cmd_stats) - 1U);
+    for (uint32_t i = 0; is_stats && i < ev->len; ++i) {
+        is_stats = (line[i] == (uint8_t)cmd_stats[i]);
+    }
+    if (is_stats) {
+        evbus_report(uart_putc_queued);   // Al anillo de TX: lo vacía uart_tx_pump()
+        return;
+    }
+    uart_puts("> ");
+    for (uint32_t i = 0; i < ev->len; ++i) {
+        uart_putc((char)line[i]);
+    }
+    uart_puts("\r\n");
+}
+EVBUS_SUBSCRIBE(EV_UART_LINE, on_uart_line);
 
 int main(void) {
-    // Deshabilitar watchdogs para bucle infinito didáctico
+    // Limpiar la configuración de watchdogs que deja la ROM; el MWDT de TIMG0
+    // se vuelve a armar más abajo con wds_start() (supervisor por tarea)
     disable_timg_wdt(TIMG0_BASE);
     disable_timg_wdt(TIMG1_BASE);
     disable_rtc_wdts();
@@ -536,64 +557,32 @@ int main(void) {
     adc_init();    
     ledc_init();
     uart_init(); 
-    timer_init()
+    timer_init();
     uart_puts("Sistema iniciado. Esperando boton/pulso...\r\n"); // Mensaje de inicio
+    boot_report();
+    trace_boot(uart_putc);        // Causa de reset + traza de la sesión anterior
+
+    wds_register(TASK_SENSOR, "sensor", SENSOR_DEADLINE_US);
+    wds_register(TASK_ACTUATOR, "actuador", ACTUATOR_DEADLINE_US);
+    wds_boot_report(uart_putc);   // Captura del stage 0 y WCET de la sesión anterior
+    wds_start(WDT_TIMEOUT_MS);
 
 
-    // Bucle principal: fade in/out con PWM
-    uint32_t duty = 0;
-    int8_t step = 1;
+    evbus_init();                 // Agrupa por tipo los handlers que juntó el enlazador
 
+    // Bucle principal: los drivers publican, los handlers reaccionan. Un sensor
+    // nuevo se agrega con EVBUS_SOURCE/EVBUS_SUBSCRIBE, sin tocar este bucle.
     while (1) {
-        /* 
-        uint32_t pulse = hcsr04_measure_pulse();
-
-        if (pulse == 0) {
-            ledc_set_duty(LEDC_DUTY_MAX);       // sin pulso → LED apagado
-        } else if (pulse > 2000) {
-            ledc_set_duty(200);     // pulso chico → objeto lejos
-        } else {
-            ledc_set_duty(LEDC_DUTY_MAX); // pulso grande → objeto cerca
-        }
+        wds_begin(TASK_SENSOR);
+        evbus_poll_sources();
+        wds_end(TASK_SENSOR);
 
+        wds_begin(TASK_ACTUATOR);
+        evbus_dispatch();
+        wds_end(TASK_ACTUATOR);
+
+        uart_tx_pump();   // Texto encolado (p.ej. "stats"): sólo lo que entra en el FIFO
         short_delay();
-        */
-        
-        
-        // 🔥 Leer GPIO2 digital
-        uint32_t button = (REG32(BUTTON_GPIO)& BUTTON_MASK) != 0U
-
-        // Medir pulso del HC-SR04
-        //uint32_t pulse = hcsr04_measure_pulse(); //Descomentar esta y comentar la de arriba para usar el sensor
-        // 1. 🔥 Leer ADC para obtener un desplazamiento (offset)
-        //uint16_t raw_adc = adc_sample_once(); 
-
-        // 2. Mapear el ADC (0-4095) a un rango de OFFSET (ej. de 0 a 3000 ticks)
-        // Esto permite que el umbral aumente hasta 3000 ticks más que el base.
-        //uint32_t threshold_offset = (raw_adc * 3000U / 4095U); 
-
-        // 3. Establecer el umbral dinámico usando el valor base + offset
-        //uint32_t dynamic_threshold = HCSR04_NEAR_THRESHOLD + threshold_offset;
-
-        // if (pulse > dynamic_threshold) {//><  // Si el pulso es mayor que cierto umbral → objeto "cerca"
-        if (button) { //comentar esta y descomentar la de arriba para usar el sensor
-            // Si el pin está ALTO → LED detiene el fade
-            ledc_set_duty(duty);
-
-            // 🔥 NUEVO: Enviar mensaje a la consola
-            // \r\n (Carriage Return + New Line) es importante para saltos de línea
-            uart_puts("!ATENCION: Deteccion activada. LED detenido.\r\n");
-
-        } else{
-            ledc_set_duty(duty);
-            duty += step;
-
-            if (duty == LEDC_DUTY_MAX || duty == 0) {
-                step = -step; // Cambio de dirección
-            }
-        }
-        
-        short_delay();
-        
+        wds_poll();   // Alimenta el MWDT sólo si todas las tareas cumplieron su plazo
     }
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * trace.c — Arranque de la traza post-mortem (ver trace.h).
+ *
+ * La causa de reset se lee de RTC_CNTL_RESET_STATE_REG (TRM ESP32-C3,
+ * cap. Reset and Clock); los códigos coinciden con los de la ROM.
+ */
+
+#include <stdint.h>
+#include "regacc.h"
+#include "rtc_noinit.h"
+#include "trace.h"
+
+#define RTC_CNTL_BASE_ADDR            0x60008000UL
+#define RTC_CNTL_RESET_STATE_REG      (RTC_CNTL_BASE_ADDR + 0x0038)
+#define RTC_CNTL_RESET_CAUSE_PROCPU_M 0x3FU
+
+#define TRACE_MAGIC 0x54524331U   // "TRC1": el anillo en RTC es válido
+
+trace_ring_t trace_ring RTC_NOINIT;
+
+static const char *trace_reason_name(uint32_t reason) {
+    switch (reason) {
+    case 1:  return "power-on";
+    case 3:  return "software (sistema)";
+    case 5:  return "deep-sleep";
+    case 7:  return "MWDT0 (sistema)";
+    case 8:  return "MWDT1 (sistema)";
+    case 9:  return "RTC WDT (sistema)";
+    case 12: return "MWDT0 (CPU)";
+    case 13: return "software (CPU)";
+    case 14: return "RTC WDT (CPU)";
+    case 15: return "brown-out";
+    case 16: return "RTC WDT (core)";
+    case 17: return "MWDT1 (CPU)";
+    case 18: return "super WDT";
+    case 19: return "glitch de reloj";
+    case 20: return "eFuse CRC";
+    case 21: return "USB UART";
+    case 22: return "USB JTAG";
+    case 23: return "glitch de alimentacion";
+    default: return "desconocido";
+    }
+}
+
+uint32_t trace_reset_reason(void) {
+    return REG32(RTC_CNTL_RESET_STATE_REG) & RTC_CNTL_RESET_CAUSE_PROCPU_M;
+}
+
+static void trace_dump(fmt_putc_t putc) {
+    uint32_t count = trace_ring.head;
+    uint32_t first = 0U;
+    if (count > TRACE_ENTRIES) {
+        first = count - TRACE_ENTRIES;   // El anillo dio la vuelta: sólo los últimos N
+    }
+    fmt_put_str(putc, "[TRACE] sesion ");
+    fmt_put_u32(putc, trace_ring.session);
+    fmt_put_str(putc, ": ");
+    fmt_put_u32(putc, count - first);
+    fmt_put_str(putc, " eventos (ts id a0 a1)\r\n");
+    for (uint32_t i = first; i != count; ++i) {
+        const trace_entry_t *e = &trace_ring.entry[i & (TRACE_ENTRIES - 1U)];
+        putc(' ');
+        fmt_put_u32(putc, e->ts);
+        putc(' ');
+        fmt_put_u32(putc, e->id);
+        putc(' ');
+        fmt_put_hex32(putc, e->a0);
+        putc(' ');
+        fmt_put_hex32(putc, e->a1);
+        fmt_put_str(putc, "\r\n");
+    }
+}
+
+void trace_boot(fmt_putc_t putc) {
+    cycles_init();   // Timestamps de la nueva sesión
+    uint32_t reason = trace_reset_reason();
+    fmt_put_str(putc, "[TRACE] causa de reset: ");
+    fmt_put_u32(putc, reason);
+    fmt_put_str(putc, " (");
+    fmt_put_str(putc, trace_reason_name(reason));
+    fmt_put_str(putc, ")\r\n");
+
+    if (trace_ring.magic == TRACE_MAGIC && trace_ring.head != 0U) {
+        trace_dump(putc);
+    } else {
+        // Power-on (o primera vez): la RTC memory tiene basura
+        trace_ring.magic = TRACE_MAGIC;
+        trace_ring.session = 0U;
+    }
+
+    trace_ring.session++;
+    trace_ring.head = 0U;
+    trace_event(TRACE_EV_BOOT, reason, trace_ring.session);
+}
@@ -0,0 +1,29 @@
+/*
+ * trap.c — Despacho de traps (interrupciones y excepciones) en C.
+ * ---------------------------------------------------------------
+ * startup.S instala una tabla de vectores (mtvec en modo vectorizado, el único
+ * que soporta el ESP32-C3). Todas las entradas saltan a _trap_entry, que guarda
+ * los registros caller-saved y llama a trap_dispatch(mcause, mepc).
+ */
+
+#include <stdint.h>
+#include "trace.h"
+#include "wdt_supervisor.h"
+
+#define MCAUSE_INTERRUPT  (1U << 31)   // 1 = interrupción, 0 = excepción
+#define MCAUSE_CODE_M     0x1FU        // Número de interrupción / causa
+
+void trap_dispatch(uint32_t mcause, uint32_t mepc) {
+    if (mcause & MCAUSE_INTERRUPT) {
+        if ((mcause & MCAUSE_CODE_M) == WDS_CPU_INT) {
+            wds_stage0_isr(mepc);
+        }
+        return;
+    }
+    // Excepción sin manejo: dejarla en la traza y quedarse aquí.
+    // El MWDT (sin alimentar) termina reseteando.
+    trace_event(TRACE_EV_EXCEPTION, mcause, mepc);
+    for (;;) {
+        __asm__ volatile("nop");
+    }
+}
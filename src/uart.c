@@ -0,0 +1,145 @@
+/*
+ * uart.c — UART0 por polling (ver uart.h).
+ *
+ * Los IO_MUX de los pines se configuran con sombras (regacc.h). `make
+ * regacc-report` compila este mismo archivo para el host y cuenta los accesos.
+ */
+
+#include <stdint.h>
+#include "soc.h"
+#include "uart.h"
+
+#define DR_REG_UART_BASE(i)     (0x60000000UL + (0x1000 * (i))) // Base para UART0 (i=0) y UART1 (i=1)
+
+#define DR_REG_UART0_BASE       DR_REG_UART_BASE(0) // 0x60000000
+
+#define UART_CLK_DIV_REG(i)     (DR_REG_UART_BASE(i) + 0x0014) // Divisor de clock (baud rate)
+#define UART_FIFO_REG(i)        (DR_REG_UART_BASE(i) + 0x0000) // Registro de datos/FIFO
+
+#define UART_STATUS_REG(i)      (DR_REG_UART_BASE(i) + 0x001C) // Registro de estado (para TX)
+#define UART_TXFIFO_CNT_S       16 // Shift para contador FIFO
+#define UART_TXFIFO_CNT_M       (0x1FFU << UART_TXFIFO_CNT_S)  // Máscara
+#define UART_FIFO_SIZE          0x7FU // Tamaño del FIFO (128 bytes)
+#define UART_RXFIFO_CNT_M       0x3FFU // Bytes disponibles en el FIFO de RX (bits 0-9)
+
+#define SYSTEM_UART_CLK_EN(i)   (1U << (i))       // i=0 para UART0, i=1 para UART1
+#define SYSTEM_UART_RST(i)      (1U << (i))
+
+// Base y Máscaras
+#define GPIO_FUNC_OUT_SEL_S     0       // Shift para el selector de función de salida
+#define IO_MUX_MCU_SEL_V        1U      // Valor 1 para seleccionar GPIO matrix (no función default)
+
+// Registros de la matriz de función (para conectar UART0 a GPIOs)
+#define GPIO_FUNC21_OUT_SEL_CFG_REG (DR_REG_GPIO_BASE + 0x05BC) // Registro de salida para GPIO21
+#define GPIO_FUNC20_IN_SEL_CFG_REG  (DR_REG_GPIO_BASE + 0x05CC) // Registro de entrada para GPIO20
+
+// Índices de la señal UART0 en la matriz
+#define U0TXD_OUT_IDX                  0x00U  // Índice de la señal U0TXD
+#define U0RXD_IN_IDX                   0x00U  // Índice de la señal U0RXD (este es el default, pero lo ponemos)
+
+// Registros IO_MUX específicos para GPIO21 y GPIO20
+#define IO_MUX_GPIO21_REG       (DR_REG_IO_MUX_BASE + 0x0058)
+#define IO_MUX_GPIO20_REG       (DR_REG_IO_MUX_BASE + 0x0054)
+
+// Definiciones adicionales para GPIO/IO_MUX para asignar pines
+#define UART0_TX_GPIO 21U
+#define UART0_RX_GPIO 20U
+#define UART0_TX_OUT_IDX 0x00U // Seleccion de funcion de salida
+#define UART0_RX_IN_IDX 0x00U  // Seleccion de funcion de entrada
+
+// Sombras en RAM de registros que sólo escribimos (ver regacc.h)
+static reg_shadow_t io_mux_gpio21  = REG_SHADOW_INIT(IO_MUX_GPIO21_REG);
+static reg_shadow_t io_mux_gpio20  = REG_SHADOW_INIT(IO_MUX_GPIO20_REG);
+
+static const reg_field_t io_mux_mcu_sel = REG_FIELD(IO_MUX_MCU_SEL_MASK, 12);
+
+// Anillo de TX para salidas largas: uart_tx_pump() lo vuelca sin esperar al FIFO
+static char uart_tx_ring[UART_TX_RING_LEN];
+static uint32_t uart_tx_head;       // Próxima posición a escribir
+static uint32_t uart_tx_tail;       // Próximo carácter a enviar
+
+void uart_init(void) {
+    // --- 1. Activar Clock y Reset UART0 ---
+    REG32(SYSTEM_PERIP_CLK_EN0_REG) |= SYSTEM_UART_CLK_EN(0);
+    REG32(SYSTEM_PERIP_RST_EN0_REG) |= SYSTEM_UART_RST(0);
+    REG32(SYSTEM_PERIP_RST_EN0_REG) &= ~SYSTEM_UART_RST(0);
+
+    // --- 2. Configurar Baud Rate (115200) ---
+    // Divisor = 40MHz / 115200 = 347.22 (usamos 347, que es 0x15B)
+    REG32(UART_CLK_DIV_REG(0)) = (347U << 4); 
+
+    // --- 3. Configurar Pines (GPIO21=TX, GPIO20=RX) ---
+    
+    // 3a. Mapear UART0 TX a GPIO21
+    // Conectar U0TXD_OUT_IDX (0x00) al GPIO21
+    REG32(GPIO_FUNC21_OUT_SEL_CFG_REG) = (U0TXD_OUT_IDX << GPIO_FUNC_OUT_SEL_S);
+    // Habilitar la salida (OE) para GPIO21
+    REG32(GPIO_ENABLE_W1TS_REG) = BIT(UART0_TX_GPIO);
+    // Configurar IO_MUX para usar la Matriz GPIO (se escribe en el lote del final)
+    reg_shadow_load(&io_mux_gpio21);
+    reg_shadow_field(&io_mux_gpio21, &io_mux_mcu_sel, IO_MUX_MCU_SEL_V);
+
+    // 3b. Mapear UART0 RX a GPIO20
+    // Conectar U0RXD_IN_IDX (0x00) al GPIO20 (con el bit de habilitación de entrada)
+    REG32(GPIO_FUNC20_IN_SEL_CFG_REG) = (U0RXD_IN_IDX << GPIO_FUNC_OUT_SEL_S) | IO_MUX_FUN_IE;
+    // Deshabilitar la salida (OE) para GPIO20
+    REG32(GPIO_ENABLE_W1TC_REG) = BIT(UART0_RX_GPIO);
+    // Configurar IO_MUX para usar la Matriz GPIO
+    reg_shadow_load(&io_mux_gpio20);
+    reg_shadow_field(&io_mux_gpio20, &io_mux_mcu_sel, IO_MUX_MCU_SEL_V);
+
+    // Write-back de ambos IO_MUX: un store por registro en lugar de dos RMW
+    reg_shadow_t *const pins[] = { &io_mux_gpio21, &io_mux_gpio20 };
+    reg_shadow_commit_all(pins, 2U);
+    
+    // Nota: Configuración de palabra (8 bits, sin paridad, 1 bit de parada) es el default y se omite por simplicidad.
+}
+
+void uart_putc(char c) {
+    // Si hay texto en el anillo, encolar detrás para no desordenar la salida
+    if (uart_tx_head != uart_tx_tail) {
+        while (uart_tx_head - uart_tx_tail >= UART_TX_RING_LEN) {
+            uart_tx_pump();
+        }
+        uart_tx_ring[uart_tx_head++ & (UART_TX_RING_LEN - 1U)] = c;
+        return;
+    }
+
+    // Esperar hasta que el FIFO no esté lleno
+    while ((REG32(UART_STATUS_REG(0)) & UART_TXFIFO_CNT_M) >= (UART_FIFO_SIZE << UART_TXFIFO_CNT_S)) {
+        // Busy-wait
+        __asm__ volatile("nop");
+    }
+    
+    // Escribir el carácter al registro FIFO (dirección 0x60000000)
+    REG32(UART_FIFO_REG(0)) = (uint32_t)c;
+}
+
+void uart_puts(const char *s) {
+    while (*s) {
+        uart_putc(*s++);
+    }
+}
+
+uint32_t uart_rx_count(void) {
+    return REG32(UART_STATUS_REG(0)) & UART_RXFIFO_CNT_M;
+}
+
+char uart_rx_byte(void) {
+    return (char)(REG32(UART_FIFO_REG(0)) & 0xFFU);
+}
+
+void uart_putc_queued(char c) {
+    if (uart_tx_head - uart_tx_tail < UART_TX_RING_LEN) {
+        uart_tx_ring[uart_tx_head++ & (UART_TX_RING_LEN - 1U)] = c;
+    }
+}
+
+uint32_t uart_tx_pump(void) {
+    uint32_t used = (REG32(UART_STATUS_REG(0)) & UART_TXFIFO_CNT_M) >> UART_TXFIFO_CNT_S;
+    while (uart_tx_head != uart_tx_tail && used < UART_FIFO_SIZE) {
+        REG32(UART_FIFO_REG(0)) = (uint32_t)uart_tx_ring[uart_tx_tail++ & (UART_TX_RING_LEN - 1U)];
+        used++;
+    }
+    return uart_tx_head - uart_tx_tail;
+}
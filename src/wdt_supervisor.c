@@ -0,0 +1,222 @@
+/*
+ * wdt_supervisor.c — Supervisor de plazos por tarea (ver wdt_supervisor.h).
+ *
+ * Registros según TRM ESP32-C3: MWDT de TIMG0 (cap. Timer Group) y matriz de
+ * interrupciones (cap. Interrupt Matrix). El estado que debe sobrevivir al
+ * reset (PC, tarea culpable, WCET) vive en RTC FAST memory (.rtc_noinit).
+ */
+
+#include <stdint.h>
+#include "regacc.h"
+#include "wdtfix.h"
+#include "cycles.h"
+#include "rtc_noinit.h"
+#include "trace.h"
+#include "wdt_supervisor.h"
+
+#define TIMG_INT_ENA_TIMERS_OFFSET  0x0070
+#define TIMG_INT_CLR_TIMERS_OFFSET  0x007C
+#define TIMG_WDT_INT                BIT(1)    // Bit de interrupción del MWDT
+
+#define TIMG_WDT_EN                 BIT(31)
+#define TIMG_WDT_STG0_S             29
+#define TIMG_WDT_STG1_S             27
+#define TIMG_WDT_CONF_UPDATE_EN     BIT(22)
+#define TIMG_WDT_USE_XTAL           BIT(21)   // Clock del MWDT: XTAL en vez de APB
+#define TIMG_WDT_CPU_RESET_LENGTH_S 18
+#define TIMG_WDT_SYS_RESET_LENGTH_S 15
+#define TIMG_WDT_CLK_PRESCALE_S     16
+#define TIMG_WDT_STG_INT            1U        // Acción de stage: interrupción
+#define TIMG_WDT_STG_RESET_SYSTEM   3U        // Acción de stage: reset de sistema
+
+#define WDS_WDT_PRESCALE    4000U   // XTAL 40 MHz / 4000 = 10 kHz -> 100 µs por tick
+                                    // (el APB depende de cómo dejó el clock el arranque)
+#define WDS_TICKS_PER_MS    10U
+#define WDS_STAGE1_MS       50U     // Margen entre la captura (stage 0) y el reset
+
+#define DR_REG_INTERRUPT_CORE0_BASE         0x600C2000UL
+#define INTERRUPT_CORE0_TG_WDT_INT_MAP_REG  (DR_REG_INTERRUPT_CORE0_BASE + 0x0084) // Fuente 33
+#define INTERRUPT_CORE0_CPU_INT_ENABLE_REG  (DR_REG_INTERRUPT_CORE0_BASE + 0x0104)
+#define INTERRUPT_CORE0_CPU_INT_TYPE_REG    (DR_REG_INTERRUPT_CORE0_BASE + 0x0108)
+#define INTERRUPT_CORE0_CPU_INT_PRI_REG(n)  (DR_REG_INTERRUPT_CORE0_BASE + 0x0114 + 4 * (n))
+#define INTERRUPT_CORE0_CPU_INT_THRESH_REG  (DR_REG_INTERRUPT_CORE0_BASE + 0x0194)
+
+#define WDS_RTC_MAGIC 0x57445331U   // "WDS1": el registro RTC es válido
+
+typedef struct {
+    uint32_t magic;
+    uint32_t fired;                 // 1 si el stage 0 saltó antes del último reset
+    uint32_t pc;                    // mepc capturado en el stage 0
+    uint32_t task;                  // Tarea culpable (o WDS_NO_TASK)
+    uint32_t wcet[WDS_MAX_TASKS];   // Peor tiempo observado, en ciclos
+} wds_rtc_record_t;
+
+static wds_rtc_record_t wds_rtc RTC_NOINIT;
+
+typedef struct {
+    const char *name;
+    uint32_t deadline;              // Plazo en ciclos
+    uint32_t start;                 // cycles_now() en wds_begin()
+} wds_task_t;
+
+static wds_task_t wds_tasks[WDS_MAX_TASKS];
+static uint32_t wds_registered;     // Máscara de tareas registradas
+static uint32_t wds_checked_in;     // Máscara de check-ins desde la última alimentación
+// Estado de la sesión: lo inicializa wds_start() (no depende de valores iniciales de .data)
+static volatile uint32_t wds_running;   // Tarea entre begin/end
+static volatile uint32_t wds_overrun;   // Primera tarea que excedió su plazo
+static volatile uint32_t wds_tripped;   // Stage 0 ya disparado: no alimentar más
+
+static void wds_feed(void) {
+    REG32(TIMG0_BASE + TIMG_WDTWPROTECT_OFFSET) = TIMG_WDT_UNLOCK_KEY;
+    REG32(TIMG0_BASE + TIMG_WDTFEED_OFFSET) = 1U;
+    REG32(TIMG0_BASE + TIMG_WDTWPROTECT_OFFSET) = 0U;
+}
+
+void wds_register(uint32_t id, const char *name, uint32_t deadline_us) {
+    if (id >= WDS_MAX_TASKS) {
+        return;
+    }
+    wds_tasks[id].name = name;
+    wds_tasks[id].deadline = deadline_us * cpu_freq_mhz();   // Clock real, no asumido
+    wds_registered |= BIT(id);
+}
+
+void wds_start(uint32_t timeout_ms) {
+    cycles_init();
+
+    // Nueva sesión: el reporte de la anterior ya se imprimió
+    wds_rtc.magic = WDS_RTC_MAGIC;
+    wds_rtc.fired = 0U;
+    wds_rtc.pc = 0U;
+    wds_rtc.task = WDS_NO_TASK;
+    for (uint32_t i = 0; i < WDS_MAX_TASKS; ++i) {
+        wds_rtc.wcet[i] = 0U;
+    }
+    wds_running = WDS_NO_TASK;
+    wds_overrun = WDS_NO_TASK;
+    wds_tripped = 0U;
+    wds_checked_in = 0U;
+
+    // MWDT: stage 0 -> interrupción tras timeout_ms, stage 1 -> reset de sistema
+    REG32(TIMG0_BASE + TIMG_WDTWPROTECT_OFFSET) = TIMG_WDT_UNLOCK_KEY;
+    REG32(TIMG0_BASE + TIMG_WDTCONFIG1_OFFSET) = (WDS_WDT_PRESCALE << TIMG_WDT_CLK_PRESCALE_S);
+    REG32(TIMG0_BASE + TIMG_WDTCONFIG2_OFFSET) = timeout_ms * WDS_TICKS_PER_MS;
+    REG32(TIMG0_BASE + TIMG_WDTCONFIG3_OFFSET) = WDS_STAGE1_MS * WDS_TICKS_PER_MS;
+    REG32(TIMG0_BASE + TIMG_WDTCONFIG0_OFFSET) = TIMG_WDT_EN
+        | (TIMG_WDT_STG_INT << TIMG_WDT_STG0_S)
+        | (TIMG_WDT_STG_RESET_SYSTEM << TIMG_WDT_STG1_S)
+        | (7U << TIMG_WDT_CPU_RESET_LENGTH_S)
+        | (7U << TIMG_WDT_SYS_RESET_LENGTH_S)
+        | TIMG_WDT_USE_XTAL
+        | TIMG_WDT_CONF_UPDATE_EN;
+    REG32(TIMG0_BASE + TIMG_WDTFEED_OFFSET) = 1U;
+    REG32(TIMG0_BASE + TIMG_WDTWPROTECT_OFFSET) = 0U;
+
+    REG32(TIMG0_BASE + TIMG_INT_CLR_TIMERS_OFFSET) = TIMG_WDT_INT;
+    REG32(TIMG0_BASE + TIMG_INT_ENA_TIMERS_OFFSET) |= TIMG_WDT_INT;
+
+    // Matriz de interrupciones: fuente TG0_WDT -> CPU int WDS_CPU_INT (nivel, prioridad 1)
+    REG32(INTERRUPT_CORE0_TG_WDT_INT_MAP_REG) = WDS_CPU_INT;
+    REG32(INTERRUPT_CORE0_CPU_INT_TYPE_REG) &= ~BIT(WDS_CPU_INT);
+    REG32(INTERRUPT_CORE0_CPU_INT_PRI_REG(WDS_CPU_INT)) = 1U;
+    REG32(INTERRUPT_CORE0_CPU_INT_THRESH_REG) = 1U;
+    REG32(INTERRUPT_CORE0_CPU_INT_ENABLE_REG) |= BIT(WDS_CPU_INT);
+
+    __asm__ volatile ("csrsi mstatus, 8");   // MIE: habilitar interrupciones globales
+}
+
+void wds_begin(uint32_t id) {
+    if (id >= WDS_MAX_TASKS) {
+        return;
+    }
+    wds_running = id;
+    wds_tasks[id].start = cycles_now();
+}
+
+void wds_end(uint32_t id) {
+    if (id >= WDS_MAX_TASKS) {
+        return;
+    }
+    uint32_t elapsed = cycles_now() - wds_tasks[id].start;
+    if (elapsed > wds_rtc.wcet[id]) {
+        wds_rtc.wcet[id] = elapsed;
+    }
+    if (elapsed > wds_tasks[id].deadline && wds_overrun == WDS_NO_TASK) {
+        wds_overrun = id;
+    }
+    wds_checked_in |= BIT(id);
+    wds_running = WDS_NO_TASK;
+}
+
+void wds_poll(void) {
+    if (wds_tripped || wds_overrun != WDS_NO_TASK) {
+        return;   // Plazo incumplido: dejar que el MWDT expire
+    }
+    if ((wds_checked_in & wds_registered) == wds_registered) {
+        wds_feed();
+        wds_checked_in = 0U;
+    }
+}
+
+void wds_stage0_isr(uint32_t mepc) {
+    uint32_t task = wds_running;
+    if (task == WDS_NO_TASK) {
+        task = wds_overrun;
+    }
+    if (task == WDS_NO_TASK) {
+        // Nadie corriendo ni excedido: culpable = primera tarea sin check-in
+        uint32_t missing = wds_registered & ~wds_checked_in;
+        for (uint32_t i = 0; i < WDS_MAX_TASKS; ++i) {
+            if (missing & BIT(i)) {
+                task = i;
+                break;
+            }
+        }
+    }
+    wds_rtc.pc = mepc;
+    wds_rtc.task = task;
+    wds_rtc.fired = 1U;
+    wds_tripped = 1U;
+    trace_event(TRACE_EV_WDT_STAGE0, mepc, task);
+    REG32(TIMG0_BASE + TIMG_INT_CLR_TIMERS_OFFSET) = TIMG_WDT_INT;
+}
+
+static void wds_put_task(fmt_putc_t putc, uint32_t id) {
+    fmt_put_u32(putc, id);
+    if (id < WDS_MAX_TASKS && wds_tasks[id].name != 0) {
+        fmt_put_str(putc, " (");
+        fmt_put_str(putc, wds_tasks[id].name);
+        putc(')');
+    }
+}
+
+void wds_boot_report(fmt_putc_t putc) {
+    if (wds_rtc.magic != WDS_RTC_MAGIC) {
+        fmt_put_str(putc, "[WDT] sin datos de la sesion anterior (power-on)\r\n");
+        return;
+    }
+    if (wds_rtc.fired) {
+        fmt_put_str(putc, "[WDT] reset por watchdog: tarea ");
+        wds_put_task(putc, wds_rtc.task);
+        fmt_put_str(putc, " PC=");
+        fmt_put_hex32(putc, wds_rtc.pc);
+        fmt_put_str(putc, "\r\n");
+    }
+    fmt_put_str(putc, "[WDT] WCET sesion anterior (ciclos / plazo):\r\n");
+    for (uint32_t i = 0; i < WDS_MAX_TASKS; ++i) {
+        if ((wds_registered & BIT(i)) == 0U) {
+            continue;
+        }
+        fmt_put_str(putc, "  ");
+        wds_put_task(putc, i);
+        fmt_put_str(putc, ": ");
+        fmt_put_u32(putc, wds_rtc.wcet[i]);
+        fmt_put_str(putc, " / ");
+        fmt_put_u32(putc, wds_tasks[i].deadline);
+        if (wds_rtc.wcet[i] > wds_tasks[i].deadline) {
+            fmt_put_str(putc, "  EXCEDIDO");
+        }
+        fmt_put_str(putc, "\r\n");
+    }
+}
@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+## tools/profiles_report.sh - Tabla comparativa de perfiles de compilación
+## ----------------------------------------------------------------------
+## Uso: tools/profiles_report.sh <perfil>=<results.txt> [...]
+## Cada results.txt es la salida de bench/run.sh (formato "<métrica> <valor>").
+## Imprime una fila por métrica (tamaños de sección y ciclos por kernel) y una
+## columna por perfil, más la diferencia de cada perfil respecto del primero.
+## Lo invoca `make profiles-report`.
+set -e
+if [ $# -eq 0 ]; then
+  echo "Uso: $0 <perfil>=<results.txt> [...]" >&2
+  exit 1
+fi
+
+ARGS=()
+for pair in "$@"; do
+  name=${pair%%=*}
+  file=${pair#*=}
+  if [ ! -f "$file" ]; then
+    echo "[ERROR] Falta $file (perfil $name)." >&2
+    exit 1
+  fi
+  ARGS+=("$file")
+  NAMES="$NAMES $name"
+done
+
+awk -v names="$NAMES" '
+  BEGIN { np = split(names, prof, " ") }
+  FILENAME != last { p++; last = FILENAME }
+  $1 ~ /^size\./ || $1 ~ /\.cycles$/ {
+    if (!($1 in seen)) { seen[$1] = 1; order[++nm] = $1 }
+    val[$1, p] = $2
+  }
+  END {
+    printf "%-26s", "metrica"
+    for (i = 1; i <= np; i++) printf " %14s", prof[i]
+    printf "\n"
+    for (m = 1; m <= nm; m++) {
+      k = order[m]
+      printf "%-26s", k
+      for (i = 1; i <= np; i++) {
+        if ((k, i) in val) {
+          if (i > 1 && (k, 1) in val && val[k, 1] != 0)
+            printf " %7d(%+4.0f%%)", val[k, i], 100.0 * (val[k, i] - val[k, 1]) / val[k, 1]
+          else
+            printf " %14d", val[k, i]
+        } else {
+          printf " %14s", "-"
+        }
+      }
+      printf "\n"
+    }
+  }
+' "${ARGS[@]}"
@@ -0,0 +1,54 @@
+/*
+ * regacc_report.c — Reporte en el host de accesos MMIO eliminados por regacc.h
+ * -------------------------------------------------------------------------
+ * Se compila con el compilador nativo (-DREGACC_HOST) junto con los drivers
+ * reales src/uart.c y src/ledc.c: REG32 y las sombras van a un banco de
+ * registros simulado y regacc.h cuenta cada lectura/escritura de los registros
+ * con sombra (IO_MUX de GPIO21/20, CONF0/CONF1 del canal LEDC).
+ *
+ * La columna "orig" son los accesos a esos mismos registros en el código que
+ * las sombras reemplazaron (REG32 directos, antes de regacc.h):
+ *   uart_init      : IO_MUX_GPIO21/20 con `&= ~MCU_SEL` y `|= MCU_SEL` -> 4 rd, 4 wr
+ *   ledc_init      : CONF0 leer/escribir + `|= PARA_UP`, CONF1 leer/escribir,
+ *                    más el ledc_set_duty(0) final -> 5 rd, 5 wr
+ *   ledc_set_duty  : CONF1 `|= DUTY_START`, CONF0 `|= PARA_UP` -> 2 rd, 2 wr por llamada
+ *
+ * Uso: make regacc-report
+ */
+
+#include <stdio.h>
+#include "regacc.h"
+#include "ledc.h"
+#include "uart.h"
+
+#define DUTY_UPDATES 1000U   // Iteraciones simuladas del bucle de fade
+
+regacc_stats_t regacc_stats;
+uintptr_t regacc_host_addr[REGACC_HOST_SLOTS];
+uint32_t  regacc_host_val[REGACC_HOST_SLOTS];
+
+static void print_stats(const char *name, uint32_t orig_reads, uint32_t orig_writes) {
+    printf("%-22s %8u %8u %8u %8u %10d %10d\n", name,
+           orig_reads, orig_writes, regacc_stats.reads, regacc_stats.writes,
+           (int)(orig_reads - regacc_stats.reads),
+           (int)(orig_writes - regacc_stats.writes));
+    regacc_stats = (regacc_stats_t){ 0 };
+}
+
+int main(void) {
+    printf("%-22s %8s %8s %8s %8s %10s %10s\n", "secuencia",
+           "orig_rd", "orig_wr", "mmio_rd", "mmio_wr", "rd_elim", "wr_elim");
+
+    uart_init();
+    print_stats("uart_init", 4U, 4U);
+
+    ledc_init();
+    print_stats("ledc_init", 5U, 5U);
+
+    for (uint32_t i = 0; i < DUTY_UPDATES; ++i) {
+        ledc_set_duty(i & LEDC_DUTY_MAX);
+    }
+    print_stats("ledc_set_duty x1000", 2U * DUTY_UPDATES, 2U * DUTY_UPDATES);
+
+    return 0;
+}